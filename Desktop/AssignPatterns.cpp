@@ -0,0 +1,263 @@
+/** @file
+    @brief App that reassigns the face plate's codes among its beacons so that
+   LEDs close together are rarely bright at the same step - cutting
+   BrightNeighbors' cost without masking any of them - and prints the firmware
+   and tracker tables to match.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "BeaconOrder.h"
+#include "CoBrightness.h"
+#include "MaskCost.h"
+#include "MaskSearch.h"
+#include "PatternSet.h"
+#include "Patterns.h"
+#include "Positions.h"
+#include "WorkStealingPool.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Independent annealing runs, each from its own random assignment, by default.
+static const int DEFAULT_RESTARTS = 32;
+/// Swaps tried per run, per pair of beacons.
+static const int SWAPS_PER_PAIR = 400;
+/// The temperature falls geometrically from the typical swap's cost change to
+/// this fraction of it.
+static const double FINAL_TEMPERATURE = 1e-4;
+/// Beacons to mask in BrightNeighbors' order instead, to compare against.
+static const int COMPARE_MASK_COUNT = 4;
+
+/// assignment[beacon] is the beacon whose original code it gets.
+using Assignment = std::vector<int>;
+
+/// A quadratic assignment problem: codes bright together at the same step
+/// cost more the closer the beacons they're put on.
+class AssignmentProblem {
+public:
+  explicit AssignmentProblem(CoBrightness const &original) : n_(original.ledCount()), flow_(n_ * n_), weight_(n_ * n_) {
+    for (int a = 0; a < n_; ++a) {
+      for (int b = 0; b < n_; ++b) {
+        flow_[a * n_ + b] = original.count(a, b);
+        weight_[a * n_ + b] = a == b ? 0. : original.stepCost(a, b);
+      }
+    }
+  }
+
+  int size() const { return n_; }
+
+  double cost(Assignment const &assignment) const {
+    double ret = 0.;
+    for (int a = 0; a < n_; ++a) {
+      for (int b = a + 1; b < n_; ++b) {
+        ret += flow(assignment[a], assignment[b]) * weight(a, b);
+      }
+    }
+    return ret;
+  }
+
+  /// The change in cost from swapping two beacons' codes.
+  double swapDelta(Assignment const &assignment, int a, int b) const {
+    double ret = 0.;
+    auto codeA = assignment[a];
+    auto codeB = assignment[b];
+    for (int k = 0; k < n_; ++k) {
+      if (k != a && k != b) {
+        auto code = assignment[k];
+        ret += (flow(codeB, code) - flow(codeA, code)) * (weight(a, k) - weight(b, k));
+      }
+    }
+    return ret;
+  }
+
+  /// Simulated annealing over swaps, from a random assignment; returns the best
+  /// one seen.
+  Assignment anneal(unsigned seed, long swaps) const {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, n_ - 1);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    Assignment current(n_);
+    std::iota(current.begin(), current.end(), 0);
+    std::shuffle(current.begin(), current.end(), rng);
+
+    double typical = 0.;
+    for (int i = 0; i < n_ * n_; ++i) {
+      auto a = pick(rng);
+      auto b = pick(rng);
+      typical += std::abs(swapDelta(current, a, b));
+    }
+    auto temperature = typical / (n_ * n_);
+    auto cooling = std::pow(FINAL_TEMPERATURE, 1. / swaps);
+
+    auto cost = this->cost(current);
+    auto best = current;
+    auto bestCost = cost;
+    for (long i = 0; i < swaps; ++i, temperature *= cooling) {
+      auto a = pick(rng);
+      auto b = pick(rng);
+      if (a == b) {
+        continue;
+      }
+      auto delta = swapDelta(current, a, b);
+      if (delta <= 0. || uniform(rng) < std::exp(-delta / temperature)) {
+        std::swap(current[a], current[b]);
+        cost += delta;
+        if (cost < bestCost) {
+          bestCost = cost;
+          best = current;
+        }
+      }
+    }
+    return best;
+  }
+
+private:
+  int flow(int codeA, int codeB) const { return flow_[codeA * n_ + codeB]; }
+  double weight(int a, int b) const { return weight_[a * n_ + b]; }
+
+  int n_;
+  std::vector<int> flow_;
+  std::vector<double> weight_;
+};
+
+static double brightNeighborsCost(PatternSet const &patterns) {
+  return MaskCost(CoBrightness(OsvrHdkLedLocations_SENSOR0, patterns)).totalCost();
+}
+
+static void printBeaconOrder(int targetNum, BeaconOrderContainer const &order) {
+  std::cout << "const BeaconOrderContainer TARGET" << targetNum << "_BEACON_ORDER = {";
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    std::cout << (i == 0 ? "" : ", ") << order[i];
+  }
+  std::cout << "};\n";
+}
+
+int main(int argc, char *argv[]) {
+  int restarts = argc > 1 ? std::atoi(argv[1]) : DEFAULT_RESTARTS;
+  int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+  if (restarts < 1 || threads < 0 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " [restarts] [threads]" << std::endl;
+    return 1;
+  }
+
+  auto codes = hdkSensor0Patterns();
+  CoBrightness original(OsvrHdkLedLocations_SENSOR0, codes);
+  AssignmentProblem problem(original);
+  auto n = problem.size();
+  long swaps = static_cast<long>(SWAPS_PER_PAIR) * n * n;
+
+  // Each run on its own seed, so the result doesn't depend on the threads.
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Assignment> results(restarts);
+  WorkStealingPool pool(threads);
+  for (int i = 0; i < restarts; ++i) {
+    pool.push([&, i] { results[i] = problem.anneal(static_cast<unsigned>(i), swaps); });
+  }
+  pool.run();
+  auto best = results[0];
+  for (auto const &result : results) {
+    if (problem.cost(result) < problem.cost(best)) {
+      best = result;
+    }
+  }
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  auto assigned = codes.selectLeds(best);
+  MaskCost base(original);
+  auto masked = MaskSearch::costOf(base, MaskSearch::greedy(base, COMPARE_MASK_COUNT));
+  auto before = base.totalCost();
+  auto after = brightNeighborsCost(assigned);
+  std::cout << "Face plate, " << n << " beacons: " << restarts << " runs of " << swaps << " swaps on "
+            << pool.threadCount() << " threads, " << seconds << " s.\n";
+  std::cout << "Total cost as assigned:          " << before << "\n";
+  std::cout << "Masking BrightNeighbors' " << COMPARE_MASK_COUNT << ":      " << masked << " ("
+            << 100. * (before - masked) / before << "% less, " << COMPARE_MASK_COUNT << " beacons lost)\n";
+  std::cout << "Reassigned, none masked:         " << after << " (" << 100. * (before - after) / before
+            << "% less)\n\n";
+
+  // Each beacon keeps its LED, so its firmware bit: only the codes move.
+  default_array_init();
+  auto firmware = PatternSet::fromPatternArray(active_pattern_rows);
+  for (int beacon = 0; beacon < n; ++beacon) {
+    auto led = oneBasedTarget0BeaconToFirmwareBit(beacon + 1);
+    for (int step = 0; step < firmware.stepCount(); ++step) {
+      firmware.set(led, step, assigned.bit(beacon, step));
+    }
+  }
+
+  std::cout << "// Patterns.cpp\nconst std::vector<std::string> OsvrHdkLedIdentifier_SENSOR0_PATTERNS = {\n";
+  for (int beacon = 0; beacon < n; ++beacon) {
+    auto const &was = OsvrHdkLedIdentifier_SENSOR0_PATTERNS[beacon];
+    auto prefix = !was.empty() && was[0] == PatternSet::DISABLED_CHAR ? std::string(1, PatternSet::DISABLED_CHAR) : "";
+    std::cout << (beacon == 0 ? "" : "    ,\n") << "    \"" << prefix << assigned.trackerString(beacon)
+              << "\" // was beacon " << best[beacon] + 1 << "'s\n";
+  }
+  std::cout << "};\n\n";
+
+  uint8_t rows[PATTERN_COUNT][LED_LINE_LENGTH];
+  firmware.toRows(rows[0], LED_LINE_LENGTH);
+  std::cout << "// array_init.c\nstatic const uint8_t production_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =\n{\n";
+  for (int step = 0; step < PATTERN_COUNT; ++step) {
+    std::cout << "    {";
+    for (int b = 0; b < LED_LINE_LENGTH; ++b) {
+      std::cout << (b == 0 ? "" : ",") << int(rows[step][b]);
+    }
+    std::cout << "}" << (step + 1 < PATTERN_COUNT ? "," : "") << "\n";
+  }
+  std::cout << "};\n\n";
+
+  // The beacon order, found again from the new tables as MatchPatterns does.
+  auto rear = hdkSensor1Patterns();
+  BeaconOrderContainer order0(n, -1);
+  BeaconOrderContainer order1(rear.ledCount(), -1);
+  for (int led = 0; led < firmware.ledCount(); ++led) {
+    auto beacon = assigned.findLed(firmware, led);
+    if (beacon >= 0) {
+      order0[beacon] = led;
+    } else if ((beacon = rear.findLed(firmware, led)) >= 0) {
+      order1[beacon] = led;
+    }
+  }
+  std::cout << "// BeaconOrder.cpp\n";
+  printBeaconOrder(0, order0);
+  printBeaconOrder(1, order1);
+  if (order0 != TARGET0_BEACON_ORDER || order1 != TARGET1_BEACON_ORDER) {
+    std::cerr << "The new tables don't match each beacon to its own LED." << std::endl;
+    return 1;
+  }
+  std::cout << "(unchanged - each beacon keeps its LED)" << std::endl;
+  return 0;
+}
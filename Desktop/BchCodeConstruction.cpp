@@ -0,0 +1,171 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "BchCodeConstruction.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <stdexcept>
+#include <vector>
+
+using Word = BchCodeConstruction::Word;
+
+/// Primitive polynomials for GF(2^m), bit n for x^n, by m.
+static const unsigned PRIMITIVE_POLYNOMIALS[] = {0, 0, 0x7, 0xB, 0x13, 0x25, 0x43};
+static const int MIN_M = 2;
+static const int MAX_M = 6;
+
+/// Carry-less product of binary polynomials - degrees summing to under 64.
+static Word multiply(Word a, Word b) {
+  Word ret = 0;
+  PatternSet::forEachBit(&b, 1, [&](int n) { ret ^= a << n; });
+  return ret;
+}
+
+static int degree(Word polynomial) {
+  int ret = -1;
+  PatternSet::forEachBit(&polynomial, 1, [&](int n) { ret = n; });
+  return ret;
+}
+
+/// GF(2^m) by exponent and log tables: exp_[i] is alpha^i.
+class GaloisField {
+public:
+  explicit GaloisField(int m) : size_((1 << m) - 1), exp_(size_), log_(size_ + 1) {
+    unsigned element = 1;
+    for (int i = 0; i < size_; ++i) {
+      exp_[i] = element;
+      log_[element] = i;
+      element <<= 1;
+      if (element >> m) {
+        element ^= PRIMITIVE_POLYNOMIALS[m];
+      }
+    }
+  }
+
+  unsigned power(int i) const { return exp_[i % size_]; }
+  unsigned times(unsigned a, unsigned b) const {
+    return a == 0 || b == 0 ? 0 : exp_[(log_[a] + log_[b]) % size_];
+  }
+
+  /// The minimal polynomial of alpha^i: the product of (x + alpha^e) over its
+  /// cyclotomic coset, whose coefficients all come out 0 or 1.
+  Word minimalPolynomial(int i) const {
+    std::vector<unsigned> coefficients{1};
+    auto e = i % size_;
+    do {
+      std::vector<unsigned> product(coefficients.size() + 1, 0);
+      for (std::size_t j = 0; j < coefficients.size(); ++j) {
+        product[j + 1] ^= coefficients[j];
+        product[j] ^= times(coefficients[j], power(e));
+      }
+      coefficients.swap(product);
+      e = e * 2 % size_;
+    } while (e != i % size_);
+    Word ret = 0;
+    for (std::size_t j = 0; j < coefficients.size(); ++j) {
+      ret |= Word(coefficients[j] & 1) << j;
+    }
+    return ret;
+  }
+
+private:
+  int size_;
+  std::vector<unsigned> exp_;
+  std::vector<int> log_;
+};
+
+BchCodeConstruction::BchCodeConstruction(CodeConstraints const &constraints) : constraints_(constraints) {
+  constraints_.validate();
+  auto n = constraints_.length;
+  int m = MIN_M;
+  while (m <= MAX_M && (1 << m) - 1 != n) {
+    ++m;
+  }
+  if (m > MAX_M) {
+    throw std::invalid_argument("BCH codes need a length of 2^m - 1: 3, 7, 15, 31 or 63");
+  }
+  if (constraints_.minDistance > n) {
+    throw std::invalid_argument("The minimum distance can't be more than the length");
+  }
+
+  // The product of the minimal polynomials of alpha to alpha^(distance - 1),
+  // once per cyclotomic coset.
+  GaloisField field(m);
+  std::vector<bool> covered(n, false);
+  for (int i = 1; i < constraints_.minDistance; ++i) {
+    if (covered[i % n]) {
+      continue;
+    }
+    for (auto e = i % n; !covered[e]; e = e * 2 % n) {
+      covered[e] = true;
+    }
+    generator_ = multiply(generator_, field.minimalPolynomial(i));
+  }
+  dimension_ = n - degree(generator_);
+}
+
+bool BchCodeConstruction::run(long long maxCodewords) {
+  auto n = constraints_.length;
+  std::vector<int> load(n, 0);
+  std::vector<Word> placed;
+  tried_ = 0;
+  // Every codeword is a message times the generator, each message once.
+  auto messages = Word(1) << dimension_;
+  for (Word message = 1; message < messages && tried_ < maxCodewords; ++message) {
+    if (static_cast<int>(placed.size()) == constraints_.codeCount) {
+      break;
+    }
+    ++tried_;
+    auto codeword = multiply(message, generator_);
+    auto weight = PatternSet::popcount(codeword);
+    if (weight < constraints_.minWeight || weight > constraints_.maxWeight) {
+      continue;
+    }
+    bool lowest = true;
+    for (int r = 1; r < n && lowest; ++r) {
+      lowest = CyclicCodeSearch::rotate(codeword, r, n) >= codeword;
+    }
+    if (!lowest) {
+      continue;
+    }
+    auto rotation = CyclicCodeSearch::bestRotation(codeword, n, load, constraints_.maxBrightPerStep);
+    if (rotation < 0) {
+      continue;
+    }
+    placed.push_back(CyclicCodeSearch::rotate(codeword, rotation, n));
+    PatternSet::forEachBit(&placed.back(), 1, [&](int step) { ++load[step]; });
+  }
+
+  codes_ = PatternSet(static_cast<int>(placed.size()), n);
+  for (std::size_t led = 0; led < placed.size(); ++led) {
+    PatternSet::forEachBit(&placed[led], 1, [&](int step) { codes_.set(static_cast<int>(led), step, true); });
+  }
+  return static_cast<int>(placed.size()) == constraints_.codeCount;
+}
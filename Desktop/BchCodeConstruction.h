@@ -0,0 +1,76 @@
+/** @file
+    @brief Header for BchCodeConstruction: cyclic LED code sets of guaranteed
+   distance, built straight from a binary BCH code rather than searched for -
+   as many codes as the code has rotation classes, in no time.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_BchCodeConstruction_h_GUID_A3F8D26C_71B4_4E59_8C0D_E52B9F174A63
+#define INCLUDED_BchCodeConstruction_h_GUID_A3F8D26C_71B4_4E59_8C0D_E52B9F174A63
+
+// Internal Includes
+#include "CyclicCodeSearch.h"
+#include "PatternSet.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+// - none
+
+/// The primitive narrow-sense BCH code of length 2^m - 1 with the constraints'
+/// minimum distance as its designed distance. The code is cyclic and linear,
+/// so two codewords of different rotation classes differ, under any rotation,
+/// by a nonzero codeword: they're at least the designed distance apart. The
+/// codes are the lowest codeword of each class, taken in order of message,
+/// within the weights, and each rotated as CyclicCodeSearch would to spread the
+/// bright steps.
+class BchCodeConstruction {
+public:
+  using Word = PatternSet::Word;
+
+  /// Throws std::invalid_argument on invalid constraints, or a length other
+  /// than 2^m - 1 for m from 2 to 6 (3 to 63 steps).
+  explicit BchCodeConstruction(CodeConstraints const &constraints);
+
+  /// Picks codes until there are enough, or maxCodewords codewords have been
+  /// tried, or there are none left. Returns whether there were enough.
+  bool run(long long maxCodewords);
+
+  PatternSet const &codes() const { return codes_; }
+  /// Bit n for x^n.
+  Word generator() const { return generator_; }
+  /// Message bits - the code has 2^dimension codewords.
+  int dimension() const { return dimension_; }
+  long long codewordsTried() const { return tried_; }
+
+private:
+  CodeConstraints constraints_;
+  Word generator_ = 1;
+  int dimension_ = 0;
+  long long tried_ = 0;
+  PatternSet codes_;
+};
+
+#endif // INCLUDED_BchCodeConstruction_h_GUID_A3F8D26C_71B4_4E59_8C0D_E52B9F174A63
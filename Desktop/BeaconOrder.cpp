@@ -0,0 +1,69 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "BeaconOrder.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+// - none
+
+const BeaconOrderContainer TARGET0_BEACON_ORDER = {34, 35, 28, 29, 30, 31, 24, 25, 26, 27, 20, 21,
+                                                   22, 23, 16, 17, 18, 19, 12, 13, 14, 15, 8,  9,
+                                                   10, 11, 4,  5,  6,  7,  0,  1,  2,  3};
+const BeaconOrderContainer TARGET1_BEACON_ORDER = {36, 37, 38, 39, 32, 33};
+
+int oneBasedTarget0BeaconToFirmwareBit(int beacon) { return TARGET0_BEACON_ORDER[beacon - 1]; }
+
+int oneBasedTarget1BeaconToFirmwareBit(int beacon) { return TARGET1_BEACON_ORDER[beacon - 1]; }
+
+int oneBasedCombinedTargetBeaconToFirmwareBit(int beacon) {
+  auto zeroBased = beacon - 1;
+  auto target0Count = static_cast<int>(TARGET0_BEACON_ORDER.size());
+  if (zeroBased < target0Count) {
+    return TARGET0_BEACON_ORDER[zeroBased];
+  }
+  return TARGET1_BEACON_ORDER[zeroBased - target0Count];
+}
+
+BeaconOrderContainer combinedBeaconOrder() {
+  auto ret = TARGET0_BEACON_ORDER;
+  ret.insert(ret.end(), TARGET1_BEACON_ORDER.begin(), TARGET1_BEACON_ORDER.end());
+  return ret;
+}
+
+BeaconOrderContainer firmwareBitToOneBasedCombinedBeacon(int ledCount) {
+  BeaconOrderContainer ret(ledCount, 0);
+  auto order = combinedBeaconOrder();
+  for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+    if (order[i] < ledCount) {
+      ret[order[i]] = i + 1;
+    }
+  }
+  return ret;
+}
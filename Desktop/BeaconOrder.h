@@ -42,22 +42,18 @@ using BeaconOrderContainer = std::vector<int>;
 /// order that the tracking software refers to them. So, the first element is
 /// referred to by the tracking software as (1-based) beacon 1, but the firmware
 /// actually thinks of it as LED 34.
-static const BeaconOrderContainer TARGET0_BEACON_ORDER = {34, 35, 28, 29, 30, 31, 24, 25, 26, 27, 20, 21,
-                                                          22, 23, 16, 17, 18, 19, 12, 13, 14, 15, 8,  9,
-                                                          10, 11, 4,  5,  6,  7,  0,  1,  2,  3};
-static const auto TARGET0_BEACON_COUNT = TARGET0_BEACON_ORDER.size();
-static const BeaconOrderContainer TARGET1_BEACON_ORDER = {36, 37, 38, 39, 32, 33};
-
-static int oneBasedTarget0BeaconToFirmwareBit(int beacon) { return TARGET0_BEACON_ORDER[beacon - 1]; }
-
-static int oneBasedTarget1BeaconToFirmwareBit(int beacon) { return TARGET1_BEACON_ORDER[beacon - 1]; }
-
-static int oneBasedCombinedTargetBeaconToFirmwareBit(int beacon) {
-  auto zeroBased = beacon - 1;
-  if (zeroBased < TARGET0_BEACON_COUNT) {
-    return TARGET0_BEACON_ORDER[zeroBased];
-  }
-  return TARGET1_BEACON_ORDER[zeroBased - TARGET0_BEACON_COUNT];
-}
+extern const BeaconOrderContainer TARGET0_BEACON_ORDER;
+extern const BeaconOrderContainer TARGET1_BEACON_ORDER;
+
+int oneBasedTarget0BeaconToFirmwareBit(int beacon);
+int oneBasedTarget1BeaconToFirmwareBit(int beacon);
+int oneBasedCombinedTargetBeaconToFirmwareBit(int beacon);
+
+/// Both targets, target 0 first - the combined beacon order.
+BeaconOrderContainer combinedBeaconOrder();
+
+/// The reverse map: the one-based combined beacon for each firmware LED, 0 for
+/// LEDs the tracker doesn't know.
+BeaconOrderContainer firmwareBitToOneBasedCombinedBeacon(int ledCount);
 
 #endif // INCLUDED_BeaconOrder_h_GUID_86CA83BB_03DE_49AF_D736_08498ABBC48C
@@ -27,29 +27,28 @@
 // SPDX-License-Identifier: Apache 2.0
 
 // Internal Includes
+#include "CoBrightness.h"
+#include "MaskCost.h"
+#include "PatternSet.h"
 #include "Patterns.h"
 #include "Positions.h"
 
 // Library/third-party includes
-#include <Eigen/Eigen>
+// - none
 
 // Standard includes
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <functional>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
 #include <sstream>
-#include <stdexcept>
 #include <tuple> // for std::tie to make comparisons simpler.
-#include <utility>
 #include <vector>
 
 using BeaconList = std::vector<int>;
 
-// these are physically not present on HDK2 hardware.
-static const BeaconList HDK2_BEACON_REMOVALS = {12, 13, 14, 25, 27, 28};
-
 // define this to start optimization with those beacons disabled.
 #define HDK2_HARDWARE
 
@@ -61,16 +60,10 @@ static const int MAX_AUTO_RUNS = 5;
 static const int MAX_AUTO_RUNS = 7;
 #endif
 
-using Eigen::Vector3d;
-
-inline double beaconSquaredDistance(Point3Vector const &locationVec, int a, int b) {
-  return (Vector3d::Map(locationVec[a].data()) - Vector3d::Map(locationVec[b].data())).squaredNorm();
-}
-
 struct BeaconAdjacentBright {
-  BeaconAdjacentBright(Point3Vector const &locationVec, int idA, int idB, int patternStepNum)
+  BeaconAdjacentBright(CoBrightness const &coBrightness, int idA, int idB, int patternStepNum)
       : beaconA_(std::min(idA, idB)), beaconB_(std::max(idA, idB)), patternStep_(patternStepNum),
-        squaredDistance_(beaconSquaredDistance(locationVec, beaconA_, beaconB_)) {}
+        squaredDistance_(coBrightness.squaredDistance(beaconA_, beaconB_)) {}
   int beaconA() const { return beaconA_; }
   int beaconB() const { return beaconB_; }
   int patternStep() const { return patternStep_; }
@@ -105,95 +98,18 @@ std::ostream &operator<<(std::ostream &os, BeaconAdjacentBright const &adj) {
 
 using AdjacentBrightnessList = std::vector<BeaconAdjacentBright>;
 
-namespace detail {
-class BrightnessTracking {
-public:
-  explicit BrightnessTracking(Point3Vector const &locationVec) : locationVec_(locationVec) {}
-
-  BrightnessTracking &operator=(BrightnessTracking const &) = delete;
-
-  void startPatternStep(int patternStep) { currentPatternStep_ = patternStep; }
-
-  void recordBrightBeacon(int newBright) {
-    for (auto &existingBright : brightBeacons_) {
-      adjacentBrightness_.emplace_back(locationVec_, existingBright, newBright, currentPatternStep_);
-      listSorted_ = false;
-    }
-    brightBeacons_.push_back(newBright);
-  }
-
-  void endPatternStep() { moveBrightBeaconsToList(); }
-
-  /// Gets the list, lazily sorted if required, on demand
-  AdjacentBrightnessList const &getSortedAdjacentBrightnessList() {
-    if (!listSorted_) {
-      sortAdjacentList();
+/// Takes the co-brightness of a set of LEDs and the costs of the LEDs masked so
+/// far (in this case, marked as being always dim), and returns the completed,
+/// sorted AdjacentBrightnessList of the rest.
+AdjacentBrightnessList computeAdjacentBrightnessList(CoBrightness const &coBrightness, MaskCost const &maskCost) {
+  AdjacentBrightnessList ret;
+  ret.reserve(maskCost.totalSteps());
+  coBrightness.forEachCoBrightStep([&](int a, int b, int patternStep) {
+    if (!maskCost.isMasked(a) && !maskCost.isMasked(b)) {
+      ret.emplace_back(coBrightness, a, b, patternStep);
     }
-    return adjacentBrightness_;
-  }
-
-private:
-  void moveBrightBeaconsToList() {
-    brightBeaconsPerStep_.emplace_back(std::move(brightBeacons_));
-    brightBeacons_.clear();
-  }
-  void sortAdjacentList() {
-    std::sort(begin(adjacentBrightness_), end(adjacentBrightness_));
-    listSorted_ = true;
-  }
-  Point3Vector const &locationVec_;
-  std::vector<BeaconList> brightBeaconsPerStep_;
-  AdjacentBrightnessList adjacentBrightness_;
-  bool listSorted_ = false;
-  BeaconList brightBeacons_;
-  int currentPatternStep_;
-};
-} // namespace detail
-
-/// Takes in parallel location and pattern vectors, as well as an optional list
-/// of one-based beacon IDs to "mask" (in this case, mark as being always dim),
-/// and returns the completed, sorted AdjacentBrightnessList.
-AdjacentBrightnessList computeAdjacentBrightnessList(Point3Vector const &locationVec,
-                                                     std::vector<std::string> patternVec,
-                                                     std::vector<int> const &oneBasedBeaconIdsToMask = {}) {
-  if (locationVec.size() != patternVec.size()) {
-    throw std::length_error("Location vec and pattern vec were different "
-                            "sizes, but must be the same!");
-  }
-
-  // Took the patternVec by value since we want a locally-writable copy.
-  auto patternLength = static_cast<int>(patternVec.back().size());
-  auto numLeds = static_cast<int>(patternVec.size());
-
-  /// Replace the pattern in every "masked" LED with all dim for the purposes of
-  /// this tool.
-  auto maskString = std::string(PATTERN_LENGTH, DIM_CHAR);
-  for (auto &maskId : oneBasedBeaconIdsToMask) {
-    // going to do range checking here
-    patternVec.at(maskId - 1) = maskString;
-  }
-
-  /// Set up helper object for the remainder of the computation.
-  auto brightness = detail::BrightnessTracking{locationVec};
-
-  /// For each pattern step...
-  for (int patternStep = 0; patternStep < patternLength; ++patternStep) {
-
-    brightness.startPatternStep(patternStep);
-
-    /// go through each beacon...
-    for (int ledNum = 0; ledNum < numLeds; ++ledNum) {
-
-      /// checking to see if it's bright
-      if (patternVec[ledNum][patternStep] == BRIGHT_CHAR) {
-        /// and if so, recording it with the brightness tracker (which takes
-        /// care of the pairwise comparison, etc)
-        brightness.recordBrightBeacon(ledNum);
-      }
-    }
-    brightness.endPatternStep();
-  }
-  return brightness.getSortedAdjacentBrightnessList();
+  });
+  return ret;
 }
 
 struct BeaconCost {
@@ -221,40 +137,17 @@ inline bool compareBeaconCostByCount(BeaconCost const &lhs, BeaconCost const &rh
 /// @param comparator A greater-than comparator of some sort that will bring
 /// your most-expensive (by your desired operational definition of that term) to
 /// the top.
-std::vector<BeaconCost> getMostExpensiveLeds(AdjacentBrightnessList const &adj,
+std::vector<BeaconCost> getMostExpensiveLeds(MaskCost const &maskCost,
                                              BeaconCostComparator comparator = &compareBeaconCostByTotalDistanceCost) {
-  using IndivCosts = std::vector<double>;
-  // Each beacon with a simultaneous bright will have a vector of the "cost" of
-  // each simultaneous bright period.
-  std::vector<IndivCosts> allCosts;
-  auto recordCost = [&](int id, double cost) {
-    if (!(id < allCosts.size())) {
-      // we need to enlarge the vector
-      allCosts.resize(id + 1);
-    }
-    allCosts.at(id).push_back(cost);
-  };
-  // Go through and record the costs of each beacon.
-  for (auto &adjElt : adj) {
-    auto cost = adjElt.cost();
-    recordCost(adjElt.beaconA(), cost);
-    recordCost(adjElt.beaconB(), cost);
-  }
-
   std::vector<BeaconCost> ret;
 
-  // Now, we need to somehow reduce the vector of costs to a single cost per
-  // LED. Right now, just doing a mean.
-  auto n = static_cast<int>(allCosts.size());
-  for (int id = 0; id < n; ++id) {
-    auto const &thisBeaconCosts = allCosts[id];
-    if (thisBeaconCosts.empty()) {
-      // no costs for this beacon
+  // The mask cost engine keeps each beacon's total up to date; beacons bright
+  // with no others have no costs.
+  for (int id = 0; id < maskCost.ledCount(); ++id) {
+    if (maskCost.isMasked(id) || maskCost.ledSteps(id) == 0) {
       continue;
     }
-    auto count = thisBeaconCosts.size();
-    auto totalCost = std::accumulate(begin(thisBeaconCosts), end(thisBeaconCosts), 0.);
-    ret.push_back(BeaconCost{id, count, totalCost});
+    ret.push_back(BeaconCost{id, static_cast<std::size_t>(maskCost.ledSteps(id)), maskCost.ledCost(id)});
   }
 
   /// Finally, the sort: want operator > in some sense.
@@ -268,11 +161,10 @@ struct OverallCosts {
   double avgCostPerPair() const { return totalCost / static_cast<double>(count); }
 };
 
-OverallCosts computeCostOfFullList(AdjacentBrightnessList const &adj) {
+OverallCosts computeCostOfFullList(MaskCost const &maskCost) {
   OverallCosts ret;
-  ret.count = adj.size();
-  auto accumHelper = [](double prev, BeaconAdjacentBright const &cur) { return prev + cur.cost(); };
-  ret.totalCost = std::accumulate(begin(adj), end(adj), 0., accumHelper);
+  ret.count = maskCost.totalSteps();
+  ret.totalCost = maskCost.totalCost();
   return ret;
 }
 
@@ -330,26 +222,31 @@ void autoCreateMask(int maxRuns, BeaconCostComparator const &comparator) {
   std::vector<int> maskList;
 #ifdef HDK2_HARDWARE
   // these are physically not present on HDK2 hardware.
-  maskList = HDK2_BEACON_REMOVALS;
+  maskList = OsvrHdk2MissingBeacons_SENSOR0;
 #endif
+  CoBrightness coBrightness(OsvrHdkLedLocations_SENSOR0, hdkSensor0Patterns());
+  MaskCost maskCost(coBrightness);
+  for (auto &maskId : maskList) {
+    maskCost.mask(maskId - 1);
+  }
   /// turn off up to 4 leds (running 5 passes)
   for (int i = 0; i < MAX_AUTO_RUNS; ++i) {
-    auto adj =
-        computeAdjacentBrightnessList(OsvrHdkLedLocations_SENSOR0, OsvrHdkLedIdentifier_SENSOR0_PATTERNS, maskList);
-    auto beaconCosts = getMostExpensiveLeds(adj, comparator);
-    auto overall = computeCostOfFullList(adj);
+    auto adj = computeAdjacentBrightnessList(coBrightness, maskCost);
+    auto beaconCosts = getMostExpensiveLeds(maskCost, comparator);
+    auto overall = computeCostOfFullList(maskCost);
     /// Dump current output.
     printOutput(i, maskList, adj, beaconCosts, overall);
 
-    /// Now, add the most expensive beacon to the mask list for next round.
+    /// Now, add the most expensive beacon to the mask list for next round -
+    /// only its pairs change.
     auto newMaskOneBased = beaconCosts.front().oneBasedId();
     std::cout << "Adding one-based beacon ID " << newMaskOneBased << " to the mask list for next round." << std::endl;
     maskList.push_back(newMaskOneBased);
+    maskCost.mask(newMaskOneBased - 1);
   }
 }
 
 int main() {
-  initPatterns();
   // autoCreateMask(MAX_AUTO_RUNS, &compareBeaconCostByCount);
   autoCreateMask(MAX_AUTO_RUNS, &compareBeaconCostByTotalDistanceCost);
 
@@ -0,0 +1,111 @@
+/** @file
+    @brief App that reports what driving more LEDs costs: for each LED count,
+   the driver chain length, the time to upload a frame through it and the
+   uploads per flash process, and what the extra dim pulses do to the process
+   length and the fastest camera rate - plus the RAM and flash the tables take.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// Outputs per driver, for chains other than the configured one.
+static const int DRIVER_OUTPUTS = 16;
+
+/// LED counts to compare the configured one with, when none are given.
+static const int DEFAULT_LED_COUNTS[] = {48, 64, 80, 96, 112};
+
+#ifdef SYNC_DELAY_TOTAL_US
+static const int SYNC_DELAY_US = SYNC_DELAY_TOTAL_US;
+#else
+static const int SYNC_DELAY_US = 0;
+#endif
+
+#ifdef ENABLE_MULTI_LEVEL
+static const int LEVEL_UPLOADS = 1;
+#else
+static const int LEVEL_UPLOADS = 0;
+#endif
+
+int main(int argc, char *argv[]) {
+  std::vector<int> ledCounts{LED_COUNT};
+  for (int i = 1; i < argc; ++i) {
+    ledCounts.push_back(std::atoi(argv[i]));
+  }
+  if (argc == 1) {
+    ledCounts.insert(ledCounts.end(), std::begin(DEFAULT_LED_COUNTS), std::end(DEFAULT_LED_COUNTS));
+  }
+
+  std::cout << "Built for " << LED_COUNT << " LEDs on a " << DRIVER_CHAIN_BITS << " bit chain. Periods (usec): bright "
+            << FLASH_BRIGHT_PERIOD << ", interval " << FLASH_INTERVAL_PERIOD << ", dim " << FLASH_DIM_PERIOD
+            << "; sync delay " << SYNC_DELAY_US << ", lockout " << FLASH_SYNC_LOCKOUT_PERIOD << "\n\n";
+  std::cout << "LEDs  chain  upload  uploads  process  frame   max Hz  RAM  flash\n";
+
+  int slipping = 0;
+  for (auto leds : ledCounts) {
+    if (leds <= 0 || leds % 8 != 0) {
+      std::cerr << "Usage: " << argv[0] << " [LED count, a multiple of 8...]" << std::endl;
+      return 1;
+    }
+    // Two outputs per LED, as expand_array() wires them.
+    int chainBits = leds == LED_COUNT ? DRIVER_CHAIN_BITS
+                                      : (2 * leds + DRIVER_OUTPUTS - 1) / DRIVER_OUTPUTS * DRIVER_OUTPUTS;
+    int lineLength = leds / 8;
+    int uploadUs = DRIVER_UPLOAD_US_FOR_BYTES(chainBits / 8);
+    // The pattern, then one dim frame per driver byte group.
+    int uploads = 1 + LEVEL_UPLOADS + lineLength;
+    int processUs =
+        FLASH_BRIGHT_PERIOD + LEVEL_PULSE_DURATION + lineLength * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD);
+    int frameUs = SYNC_DELAY_US + processUs + FLASH_SYNC_LOCKOUT_PERIOD;
+    // pattern_array, ir_led_driver_buffer and driver_mask; the flash frames and masks.
+    int ramBytes = PATTERN_COUNT * 3 * lineLength + 2 * lineLength;
+    int flashBytes = (PATTERN_COUNT + PATTERN_BANK_COUNT) * 2 * lineLength;
+
+    std::cout << std::setw(4) << leds << std::setw(7) << chainBits << std::setw(8) << uploadUs << std::setw(9)
+              << uploads << std::setw(9) << processUs << std::setw(7) << frameUs << std::setw(9) << std::fixed
+              << std::setprecision(1) << 1e6 / frameUs << std::setw(5) << ramBytes << std::setw(7) << flashBytes;
+    if (uploadUs > FLASH_INTERVAL_PERIOD) {
+      std::cout << "  dim pulses slip: upload > interval";
+      ++slipping;
+    }
+    if (frameUs > MAX_TOTAL_DURATION) {
+      std::cout << "  over MAX_TOTAL_DURATION";
+    }
+    std::cout << "\n";
+  }
+
+  std::cout << "\nchain: bits shifted per frame; upload: usec per frame (main loop, between pulses); uploads: per "
+               "flash process; frame: usec from sync to the end of the lockout.\n";
+  return slipping == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/** @file
+    @brief App that checks "AR" settings dumps in a console log: verifies each
+   dump's CRC against its fields, and lists the boards (by configuration CRC)
+   so a fleet audit can spot the odd one out.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Same as dump_crc_update() in uart_protocol.c
+static uint16_t crcUpdate(uint16_t crc, uint8_t val) {
+  crc ^= static_cast<uint16_t>(val << 8);
+  for (int i = 0; i < 8; ++i) {
+    crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+  }
+  return crc;
+}
+
+struct Dump {
+  /// Line of the log where the dump starts.
+  int line = 0;
+  std::string build;
+  uint16_t crc = 0xFFFF;
+  int sentCrc = -1;
+  int rows = 0;
+};
+
+/// Adds the comma-separated hex fields of a line to the CRC, as the firmware
+/// does: 4-digit fields are two bytes, shorter ones a byte.
+static void addFields(std::string const &fields, Dump &dump) {
+  std::istringstream is(fields);
+  std::string field;
+  while (std::getline(is, field, ',')) {
+    if (field.empty()) {
+      continue;
+    }
+    auto value = std::strtoul(field.c_str(), nullptr, 16);
+    if (field.size() == 4) {
+      dump.crc = crcUpdate(dump.crc, static_cast<uint8_t>(value >> 8));
+    }
+    dump.crc = crcUpdate(dump.crc, static_cast<uint8_t>(value));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <console log with AR dumps>" << std::endl;
+    return 1;
+  }
+  std::ifstream file(argv[1]);
+  if (!file) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::vector<Dump> dumps;
+  bool inDump = false;
+  std::string text;
+  for (int line = 1; std::getline(file, text); ++line) {
+    auto start = text.find("AR:");
+    if (start == std::string::npos || text.size() < start + 5 || text[start + 4] != ':') {
+      continue;
+    }
+    auto kind = text[start + 3];
+    auto rest = text.substr(start + 5);
+    if (!rest.empty() && rest.back() == '\r') {
+      rest.pop_back();
+    }
+    if (kind == 'T') {
+      dumps.emplace_back();
+      dumps.back().line = line;
+      inDump = true;
+    } else if (!inDump) {
+      continue;
+    }
+    auto &dump = dumps.back();
+    switch (kind) {
+    case 'P':
+      // "i:row bytes" - the row index is a field too.
+      addFields(rest.substr(0, 1) + "," + rest.substr(2), dump);
+      ++dump.rows;
+      break;
+    case 'T':
+    case 'K':
+    case 'M':
+      addFields(rest, dump);
+      break;
+    case 'V':
+      dump.build = rest;
+      break;
+    case 'C':
+      dump.sentCrc = static_cast<int>(std::strtoul(rest.c_str(), nullptr, 16));
+      inDump = false;
+      break;
+    default:
+      break;
+    }
+  }
+
+  int bad = 0;
+  std::map<uint16_t, int> boardsByCrc;
+  for (auto const &dump : dumps) {
+    std::cout << "line " << dump.line << ": ";
+    if (dump.sentCrc < 0 || dump.rows != PATTERN_COUNT) {
+      std::cout << "incomplete dump (" << dump.rows << " of " << PATTERN_COUNT << " rows)\n";
+      ++bad;
+      continue;
+    }
+    if (dump.sentCrc != dump.crc) {
+      std::cout << "CRC mismatch - corrupted in transit\n";
+      ++bad;
+      continue;
+    }
+    std::cout << "config " << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << dump.crc << std::dec
+              << std::setfill(' ') << " " << dump.build << "\n";
+    ++boardsByCrc[dump.crc];
+  }
+
+  std::cout << "\n"
+            << dumps.size() << " dumps, " << bad << " bad, " << boardsByCrc.size() << " distinct configurations\n";
+  for (auto const &entry : boardsByCrc) {
+    std::cout << "  " << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << entry.first << std::dec
+              << std::setfill(' ') << ": " << entry.second << " board(s)\n";
+  }
+  return bad == 0 ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "CoBrightness.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <stdexcept>
+
+CoBrightness::CoBrightness(Point3Vector const &locations, PatternSet const &patterns)
+    : ledCount_(patterns.ledCount()), patterns_(patterns), counts_(ledCount_ * ledCount_),
+      squaredDistances_(ledCount_ * ledCount_) {
+  if (static_cast<int>(locations.size()) != ledCount_) {
+    throw std::length_error("Location vec and pattern set were different "
+                            "sizes, but must be the same!");
+  }
+  auto words = patterns_.ledWordCount();
+  for (int a = 0; a < ledCount_; ++a) {
+    auto codeA = patterns_.ledWords(a);
+    for (int b = a + 1; b < ledCount_; ++b) {
+      auto codeB = patterns_.ledWords(b);
+      int count = 0;
+      for (int i = 0; i < words; ++i) {
+        count += PatternSet::popcount(codeA[i] & codeB[i]);
+      }
+      double squared = 0.;
+      for (int axis = 0; axis < 3; ++axis) {
+        auto delta = locations[a][axis] - locations[b][axis];
+        squared += delta * delta;
+      }
+      counts_[a * ledCount_ + b] = counts_[b * ledCount_ + a] = count;
+      squaredDistances_[a * ledCount_ + b] = squaredDistances_[b * ledCount_ + a] = squared;
+      if (count != 0) {
+        pairs_.push_back(Pair{squared, a, b, count});
+        coBrightSteps_ += count;
+      }
+    }
+  }
+}
+
+std::vector<CoBrightness::Pair> CoBrightness::sortedPairs() const {
+  auto ret = pairs_;
+  std::sort(ret.begin(), ret.end(), [](Pair const &x, Pair const &y) {
+    return x.squaredDistance != y.squaredDistance ? x.squaredDistance < y.squaredDistance
+                                                  : (x.a != y.a ? x.a < y.a : x.b < y.b);
+  });
+  return ret;
+}
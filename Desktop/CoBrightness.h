@@ -0,0 +1,122 @@
+/** @file
+    @brief Header for CoBrightness: how often each pair of LEDs is bright at
+   the same step, and how far apart they are - the inputs to BrightNeighbors'
+   costs, computed with AND+popcount over the packed codes rather than a scan
+   of every step.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_CoBrightness_h_GUID_9B4E2F61_0C7A_4D38_B5E1_62A8D3F07C94
+#define INCLUDED_CoBrightness_h_GUID_9B4E2F61_0C7A_4D38_B5E1_62A8D3F07C94
+
+// Internal Includes
+#include "PatternSet.h"
+#include "Positions.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <vector>
+
+class CoBrightness {
+public:
+  /// Locations and patterns are parallel: LED n of the set is at locations[n].
+  /// Throws std::length_error if they aren't the same size.
+  CoBrightness(Point3Vector const &locations, PatternSet const &patterns);
+
+  int ledCount() const { return ledCount_; }
+  PatternSet const &patterns() const { return patterns_; }
+
+  /// Steps at which both LEDs are bright.
+  int count(int a, int b) const { return counts_[a * ledCount_ + b]; }
+  double squaredDistance(int a, int b) const { return squaredDistances_[a * ledCount_ + b]; }
+  /// BrightNeighbors' cost of one step bright together: the inverse square of
+  /// the distance.
+  double stepCost(int a, int b) const { return 1. / squaredDistance(a, b); }
+
+  /// A pair (a < b) bright together at least once.
+  struct Pair {
+    double squaredDistance;
+    int a;
+    int b;
+    int count;
+  };
+  std::vector<Pair> const &pairs() const { return pairs_; }
+  /// Steps bright together, summed over the pairs - the report's length.
+  int coBrightSteps() const { return coBrightSteps_; }
+  /// The pairs nearest first, then by a and b.
+  std::vector<Pair> sortedPairs() const;
+
+  /// Calls f(a, b, step) for each step each pair is bright together, in
+  /// BrightNeighbors' report order: nearest first, then by step, a and b.
+  template <typename F> void forEachCoBrightStep(F &&f) const;
+
+private:
+  int ledCount_;
+  int coBrightSteps_ = 0;
+  PatternSet patterns_;
+  std::vector<int> counts_;
+  std::vector<double> squaredDistances_;
+  std::vector<Pair> pairs_;
+};
+
+template <typename F> inline void CoBrightness::forEachCoBrightStep(F &&f) const {
+  struct Entry {
+    int step;
+    int a;
+    int b;
+  };
+  std::vector<Entry> tied;
+  auto ledWords = patterns_.ledWordCount();
+  auto sorted = sortedPairs();
+  auto first = sorted.begin();
+  while (first != sorted.end()) {
+    // Pairs the same distance apart interleave by step.
+    auto last = first;
+    tied.clear();
+    for (; last != sorted.end() && last->squaredDistance == first->squaredDistance; ++last) {
+      auto codeA = patterns_.ledWords(last->a);
+      auto codeB = patterns_.ledWords(last->b);
+      for (int i = 0; i < ledWords; ++i) {
+        auto both = codeA[i] & codeB[i];
+        PatternSet::forEachBit(&both, 1, [&](int step) {
+          tied.push_back(Entry{i * PatternSet::WORD_BITS + step, last->a, last->b});
+        });
+      }
+    }
+    if (last - first > 1) {
+      std::sort(tied.begin(), tied.end(), [](Entry const &x, Entry const &y) {
+        return x.step != y.step ? x.step < y.step : (x.a != y.a ? x.a < y.a : x.b < y.b);
+      });
+    }
+    for (auto const &entry : tied) {
+      f(entry.a, entry.b, entry.step);
+    }
+    first = last;
+  }
+}
+
+#endif // INCLUDED_CoBrightness_h_GUID_9B4E2F61_0C7A_4D38_B5E1_62A8D3F07C94
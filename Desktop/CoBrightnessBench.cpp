@@ -0,0 +1,201 @@
+/** @file
+    @brief App that times BrightNeighbors' co-brightness list on random LED
+   layouts and codes, from the HDK's size up to hundreds of LEDs: the original
+   scan of every step against the CoBrightness engine, checking that both give
+   the same sorted list - and what MaskCost takes to try masking an LED
+   against working it out again from scratch.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "CoBrightness.h"
+#include "MaskCost.h"
+#include "PatternSet.h"
+#include "Positions.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static const int DEFAULT_STEPS = 64;
+static const int DEFAULT_LED_COUNTS[] = {34, 128, 256, 512, 1024};
+/// Bright at a quarter of the steps, like the HDK's codes.
+static const int BRIGHT_FRACTION = 4;
+/// Runs of each method are repeated for at least this long.
+static const double MIN_TIMING_MS = 200.;
+
+/// Squared distance, step, LED a, LED b - sorted, the report's order.
+using Entry = std::tuple<double, int, int, int>;
+
+/// The original BrightNeighbors computation: a character at a time through
+/// every step, every pair bright at it distanced and listed, then the list
+/// sorted.
+static std::vector<Entry> scanEveryStep(Point3Vector const &locations, std::vector<std::string> const &codes) {
+  std::vector<Entry> ret;
+  auto steps = static_cast<int>(codes.front().size());
+  std::vector<int> bright;
+  for (int step = 0; step < steps; ++step) {
+    bright.clear();
+    for (int led = 0; led < static_cast<int>(codes.size()); ++led) {
+      if (codes[led][step] != PatternSet::BRIGHT_CHAR) {
+        continue;
+      }
+      for (auto other : bright) {
+        double squared = 0.;
+        for (int axis = 0; axis < 3; ++axis) {
+          auto delta = locations[other][axis] - locations[led][axis];
+          squared += delta * delta;
+        }
+        ret.emplace_back(squared, step, other, led);
+      }
+      bright.push_back(led);
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+static std::vector<Entry> useEngine(Point3Vector const &locations, PatternSet const &patterns) {
+  std::vector<Entry> ret;
+  CoBrightness coBrightness(locations, patterns);
+  ret.reserve(coBrightness.coBrightSteps());
+  coBrightness.forEachCoBrightStep(
+      [&](int a, int b, int step) { ret.emplace_back(coBrightness.squaredDistance(a, b), step, a, b); });
+  return ret;
+}
+
+/// Masks each of the LEDs in turn and checks the incremental costs against
+/// costs worked out again with it cleared, then undoes it all.
+static bool masksMatchRecomputed(Point3Vector const &locations, PatternSet patterns, MaskCost &maskCost, int count) {
+  bool ret = true;
+  for (int led = 0; led < count; ++led) {
+    maskCost.mask(led);
+    patterns.clearLed(led);
+    MaskCost recomputed(CoBrightness(locations, patterns));
+    ret = ret && maskCost.totalSteps() == recomputed.totalSteps() &&
+          std::abs(maskCost.totalCost() - recomputed.totalCost()) <= 1e-9 * recomputed.totalCost();
+  }
+  auto before = maskCost.totalCost();
+  maskCost.unmask(0);
+  maskCost.undo();
+  ret = ret && maskCost.totalCost() == before;
+  while (maskCost.undoDepth() != 0) {
+    maskCost.undo();
+  }
+  return ret;
+}
+
+/// Milliseconds per call of f, repeated for at least MIN_TIMING_MS.
+template <typename F> static double timeMs(F &&f) {
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  int runs = 0;
+  double elapsed = 0.;
+  do {
+    f();
+    ++runs;
+    elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  } while (elapsed < MIN_TIMING_MS);
+  return elapsed / runs;
+}
+
+int main(int argc, char *argv[]) {
+  auto steps = argc > 1 ? std::atoi(argv[1]) : DEFAULT_STEPS;
+  std::vector<int> ledCounts;
+  for (int i = 2; i < argc; ++i) {
+    ledCounts.push_back(std::atoi(argv[i]));
+  }
+  if (ledCounts.empty()) {
+    ledCounts.assign(std::begin(DEFAULT_LED_COUNTS), std::end(DEFAULT_LED_COUNTS));
+  }
+  if (steps < BRIGHT_FRACTION || std::any_of(ledCounts.begin(), ledCounts.end(), [](int n) { return n < 2; })) {
+    std::cerr << "Usage: " << argv[0] << " [steps] [LED count...]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Random codes, " << steps << " steps, " << steps / BRIGHT_FRACTION
+            << " bright; random locations in a 200 mm cube.\n";
+  std::cout << "LEDs  co-bright steps     scan ms   engine ms  speedup  counts ms  mask+undo us  what-if us\n";
+  std::mt19937 rng(2016);
+  std::uniform_real_distribution<double> coordinate(-100., 100.);
+  int mismatches = 0;
+  for (auto leds : ledCounts) {
+    Point3Vector locations(leds);
+    PatternSet patterns(leds, steps);
+    std::vector<int> order(steps);
+    for (int led = 0; led < leds; ++led) {
+      locations[led] = Point3{coordinate(rng), coordinate(rng), coordinate(rng)};
+      std::iota(order.begin(), order.end(), 0);
+      std::shuffle(order.begin(), order.end(), rng);
+      for (int i = 0; i < steps / BRIGHT_FRACTION; ++i) {
+        patterns.set(led, order[i], true);
+      }
+    }
+    auto codes = patterns.trackerStrings();
+
+    auto expected = scanEveryStep(locations, codes);
+    auto actual = useEngine(locations, patterns);
+    auto scanMs = timeMs([&] { scanEveryStep(locations, codes); });
+    auto engineMs = timeMs([&] { useEngine(locations, patterns); });
+    auto countsMs = timeMs([&] { CoBrightness(locations, patterns); });
+
+    MaskCost maskCost(CoBrightness(locations, patterns));
+    auto startingCost = maskCost.totalCost();
+    auto masksMatch = masksMatchRecomputed(locations, patterns, maskCost, std::min(leds, 4)) &&
+                      maskCost.totalCost() == startingCost;
+    auto maskUs = 1000. * timeMs([&] {
+      for (int led = 0; led < leds; ++led) {
+        maskCost.mask(led);
+        maskCost.undo();
+      }
+    }) / leds;
+    auto whatIfUs = 1000. * timeMs([&] { maskCost.costIfMasked(); });
+
+    std::cout << std::setw(4) << leds << std::setw(17) << expected.size() << std::fixed << std::setprecision(3)
+              << std::setw(12) << scanMs << std::setw(12) << engineMs << std::setprecision(1) << std::setw(8)
+              << scanMs / engineMs << "x" << std::setprecision(3) << std::setw(11) << countsMs << std::setw(14)
+              << maskUs << std::setw(12) << whatIfUs;
+    if (actual != expected || !masksMatch) {
+      std::cout << "  MISMATCH";
+      ++mismatches;
+    }
+    std::cout << "\n";
+  }
+  std::cout << "\nengine: the sorted list BrightNeighbors prints; counts: just the co-bright count and distance "
+               "matrices, all the costs need; mask+undo: masking one LED and undoing it, with every cost kept "
+               "current; what-if: the total cost with each LED masked, for all of them.\n";
+  return mismatches == 0 ? 0 : 1;
+}
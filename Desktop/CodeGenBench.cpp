@@ -0,0 +1,147 @@
+/** @file
+    @brief App that compares the two ways of making a cyclic LED code set - the
+   CyclicCodeSearch and the BchCodeConstruction - on time and on the sets they
+   give: the distance actually reached, the bright steps per code (LED power)
+   and the most LEDs bright at one step, from tens of codes to a thousand.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "BchCodeConstruction.h"
+#include "CyclicCodeSearch.h"
+#include "PatternSet.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+/// Codes, steps, distance, and the light codes the search looks through - it
+/// can't look through every weight as the construction does.
+struct Case {
+  int codes;
+  int length;
+  int distance;
+  int searchMinWeight;
+  int searchMaxWeight;
+};
+static const Case CASES[] = {{40, 31, 4, 4, 6}, {80, 31, 4, 4, 6},  {200, 31, 4, 4, 6},
+                             {80, 63, 4, 4, 5}, {400, 63, 4, 4, 5}, {1000, 63, 4, 4, 5}};
+/// Seconds the search takes before giving up.
+static const double SEARCH_SECONDS = 5.;
+static const long long BCH_MAX_CODEWORDS = 100000000;
+
+struct Result {
+  bool found;
+  double ms;
+  int distance;
+  double meanWeight;
+  int busiestStep;
+};
+
+static Result measure(bool found, double ms, PatternSet const &codes) {
+  Result ret{found, ms, codes.stepCount(), 0., 0};
+  for (int a = 0; a < codes.ledCount(); ++a) {
+    ret.meanWeight += codes.brightSteps(a);
+    for (int b = a + 1; b < codes.ledCount(); ++b) {
+      ret.distance =
+          std::min(ret.distance, CyclicCodeSearch::cyclicDistance(codes.code(a), codes.code(b), codes.stepCount()));
+    }
+  }
+  ret.meanWeight /= std::max(1, codes.ledCount());
+  for (int step = 0; step < codes.stepCount(); ++step) {
+    ret.busiestStep = std::max(ret.busiestStep, codes.brightLeds(step));
+  }
+  return ret;
+}
+
+template <typename F> static double timeMs(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printResult(Result const &result) {
+  std::cout << std::fixed << std::setprecision(1) << std::setw(11) << result.ms;
+  if (!result.found) {
+    std::cout << "    gave up           ";
+    return;
+  }
+  std::cout << std::setw(6) << result.distance << std::setw(8) << result.meanWeight << std::setw(8)
+            << result.busiestStep;
+}
+
+int main(int argc, char *argv[]) {
+  auto threads = argc > 1 ? std::atoi(argv[1]) : 0;
+  if (threads < 0 || argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [search threads]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "No limit on LEDs bright per step; the construction takes any weight.\n\n";
+  std::cout << "                 |             search                |              BCH\n";
+  std::cout << "Codes Steps Dist |    time ms  dist  bright busiest |    time ms  dist  bright busiest\n";
+  int failures = 0;
+  for (auto const &c : CASES) {
+    CodeConstraints searchConstraints{c.codes, c.length, c.distance, c.codes, c.searchMinWeight, c.searchMaxWeight};
+    CodeConstraints bchConstraints{c.codes, c.length, c.distance, c.codes, 1, c.length};
+
+    // Each timed from the constraints: the search lists its candidates first.
+    PatternSet searchCodes;
+    bool searchFound = false;
+    auto searchMs = timeMs([&] {
+      CyclicCodeSearch search(searchConstraints, threads);
+      searchFound = search.run(SEARCH_SECONDS);
+      searchCodes = search.codes();
+    });
+    auto searchResult = measure(searchFound, searchMs, searchCodes);
+
+    PatternSet bchCodes;
+    bool bchFound = false;
+    auto bchMs = timeMs([&] {
+      BchCodeConstruction construction(bchConstraints);
+      bchFound = construction.run(BCH_MAX_CODEWORDS);
+      bchCodes = construction.codes();
+    });
+    auto bchResult = measure(bchFound, bchMs, bchCodes);
+
+    std::cout << std::setw(5) << c.codes << std::setw(6) << c.length << std::setw(5) << c.distance << " |";
+    printResult(searchResult);
+    std::cout << " |";
+    printResult(bchResult);
+    if ((searchFound && searchResult.distance < c.distance) || !bchFound || bchResult.distance < c.distance) {
+      std::cout << "  FAILED";
+      ++failures;
+    }
+    std::cout << "\n";
+  }
+  std::cout << "\ndist: the least distance under rotation between two codes of the set; bright: bright steps per "
+               "code, on average - LED power; busiest: the most codes bright at one step.\n";
+  return failures == 0 ? 0 : 1;
+}
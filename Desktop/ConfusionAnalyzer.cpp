@@ -0,0 +1,214 @@
+/** @file
+    @brief App that checks how well a set of device assignments (pattern bank
+   and phase, see DeviceSlot in array_init.h) keeps several devices in front of
+   one camera apart: the worst-case code distance between LEDs of different
+   devices, and the expected rate at which an LED gets identified as another
+   device's under a per-frame bit error model.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "PatternSet.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static_assert(PATTERN_COUNT <= 32, "Codes are held in a uint32_t");
+using Code = uint32_t;
+static const Code CODE_MASK = PATTERN_COUNT == 32 ? 0xffffffff : ((Code(1) << PATTERN_COUNT) - 1);
+
+static const double DEFAULT_BIT_ERROR_RATE = 0.01;
+
+struct Assignment {
+  int bank;
+  int phase;
+};
+
+inline Code rotate(Code c, int r) {
+  if (r == 0) {
+    return c;
+  }
+  return ((c << r) | (c >> (PATTERN_COUNT - r))) & CODE_MASK;
+}
+
+/// An LED's code as seen by the camera: bit k is whether it's lit at the k-th
+/// sync, counting from a common start, given the device's phase.
+Code getCode(Assignment const &dev, PatternSet const &bank, int led) {
+  // Starting at row phase is the bank's own code rotated down by phase.
+  return rotate(static_cast<Code>(bank.code(led)), (PATTERN_COUNT - dev.phase) % PATTERN_COUNT);
+}
+
+inline int distance(Code a, Code b) { return PatternSet::popcount(a ^ b); }
+
+/// Probability that bit errors make a code look at least as close to another
+/// code d bits away as to itself - ties count half.
+double confusionProbability(int d, double p) {
+  double ret = 0.;
+  for (int k = (d + 1) / 2; k <= d; ++k) {
+    auto term = std::exp(std::lgamma(d + 1.) - std::lgamma(k + 1.) - std::lgamma(d - k + 1.)) * std::pow(p, k) *
+                std::pow(1. - p, d - k);
+    ret += (2 * k == d) ? term / 2. : term;
+  }
+  return ret;
+}
+
+struct TrackedLed {
+  int device;
+  int led;
+  Code code;
+};
+
+struct Report {
+  int worstDistance = PATTERN_COUNT;
+  int identicalPairs = 0;
+  /// Mean over LEDs of the (union-bounded) probability of matching another
+  /// device's code.
+  double misidentificationRate = 0.;
+};
+
+/// With phaseKnown, the tracker compares codes aligned to the sync count (e.g.
+/// from phase reports). Otherwise it has to accept any rotation, as it does now.
+Report analyze(std::vector<TrackedLed> const &leds, bool phaseKnown, double p) {
+  Report ret;
+  for (auto const &a : leds) {
+    double misId = 0.;
+    for (auto const &b : leds) {
+      if (a.device == b.device) {
+        continue;
+      }
+      auto rotations = phaseKnown ? 1 : PATTERN_COUNT;
+      for (int r = 0; r < rotations; ++r) {
+        auto d = distance(a.code, rotate(b.code, r));
+        ret.worstDistance = std::min(ret.worstDistance, d);
+        if (d == 0 && a.device < b.device) {
+          ++ret.identicalPairs;
+        }
+        misId += confusionProbability(d, p);
+      }
+    }
+    ret.misidentificationRate += std::min(1., misId);
+  }
+  if (!leds.empty()) {
+    ret.misidentificationRate /= leds.size();
+  }
+  return ret;
+}
+
+/// For reference: how close a device's own LEDs already are to each other,
+/// regardless of rotation.
+int worstSelfDistance(std::vector<TrackedLed> const &leds) {
+  int ret = PATTERN_COUNT;
+  for (auto const &a : leds) {
+    for (auto const &b : leds) {
+      if (a.device != b.device || a.led == b.led) {
+        continue;
+      }
+      for (int r = 0; r < PATTERN_COUNT; ++r) {
+        ret = std::min(ret, distance(a.code, rotate(b.code, r)));
+      }
+    }
+  }
+  return ret;
+}
+
+void printReport(std::string const &title, Report const &report) {
+  std::cout << title << ": worst cross-device distance " << report.worstDistance << ", " << report.identicalPairs
+            << " identical LED pairs, misidentification rate " << std::scientific << std::setprecision(3)
+            << report.misidentificationRate << std::fixed << "\n";
+}
+
+bool parseAssignment(std::string const &arg, Assignment &out) {
+  auto colon = arg.find(':');
+  if (colon == std::string::npos) {
+    return false;
+  }
+  out.bank = std::atoi(arg.substr(0, colon).c_str());
+  out.phase = std::atoi(arg.substr(colon + 1).c_str());
+  return out.bank >= 0 && out.bank < PATTERN_BANK_COUNT && out.phase >= 0 && out.phase < PATTERN_COUNT;
+}
+
+int main(int argc, char *argv[]) {
+  double p = DEFAULT_BIT_ERROR_RATE;
+  int maskBank = DEFAULT_PATTERN_BANK;
+  std::vector<Assignment> devices;
+  if (argc > 1) {
+    p = std::atof(argv[1]);
+  }
+  if (argc > 2) {
+    maskBank = std::atoi(argv[2]);
+  }
+  for (int i = 3; i < argc; ++i) {
+    Assignment dev;
+    if (!parseAssignment(argv[i], dev)) {
+      std::cerr << "Bad device assignment " << argv[i] << std::endl;
+      return 1;
+    }
+    devices.push_back(dev);
+  }
+  if (devices.empty()) {
+    for (auto const &slot : device_slots) {
+      devices.push_back(Assignment{slot.pattern_bank, slot.phase});
+    }
+  }
+  if (p < 0. || p > 0.5 || maskBank < 0 || maskBank >= PATTERN_BANK_COUNT) {
+    std::cerr << "Usage: " << argv[0] << " [bit error rate] [mask bank] [bank:phase ...]\n"
+              << "With no assignments, uses the firmware's device slots." << std::endl;
+    return 1;
+  }
+
+  std::vector<PatternSet> banks;
+  for (auto const &bank : pattern_banks) {
+    banks.push_back(PatternSet::fromPatternArray(bank.patterns));
+  }
+  // Masked LEDs never light, so the tracker never sees them.
+  auto mask = PatternSet::fromRows(pattern_banks[maskBank].mask, LED_LINE_LENGTH, 1, LED_COUNT);
+
+  std::vector<TrackedLed> leds;
+  for (std::size_t dev = 0; dev < devices.size(); ++dev) {
+    std::cout << "Device " << dev + 1 << ": pattern bank " << devices[dev].bank << ", phase " << devices[dev].phase
+              << "\n";
+    PatternSet::forEachBit(mask.stepWords(0), mask.stepWordCount(), [&](int led) {
+      leds.push_back(TrackedLed{static_cast<int>(dev), led, getCode(devices[dev], banks[devices[dev].bank], led)});
+    });
+  }
+  std::cout << leds.size() << " tracked LEDs (mask bank " << maskBank << "), bit error rate " << p << "\n";
+  std::cout << "Worst distance between LEDs of the same device, any rotation: " << worstSelfDistance(leds) << "\n\n";
+
+  printReport("Phase unknown (any rotation)", analyze(leds, false, p));
+  printReport("Phase known (aligned codes) ", analyze(leds, true, p));
+  std::cout << "\nPhases only tell devices apart when the tracker knows them - with the same bank, a device is "
+               "just a rotation of another."
+            << std::endl;
+  return 0;
+}
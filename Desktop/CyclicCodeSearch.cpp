@@ -0,0 +1,316 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "CyclicCodeSearch.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <stdexcept>
+
+/// Levels of the search tree whose siblings are handed to the pool - below
+/// them, a task searches its subtree depth first on one thread.
+static const std::size_t SPLIT_DEPTH = 3;
+/// Partial sets each restart of the first round may try.
+static const long long FIRST_RESTART_NODES = 10000;
+
+void CodeConstraints::validate() const {
+  if (codeCount < 1 || length < 1 || length > PatternSet::WORD_BITS) {
+    throw std::invalid_argument("Code count and length must be positive, length at most 64");
+  }
+  if (minDistance < 1 || maxBrightPerStep < 1) {
+    throw std::invalid_argument("Minimum distance and bright codes per step must be positive");
+  }
+  if (minWeight < 1 || minWeight > maxWeight || maxWeight > length) {
+    throw std::invalid_argument("Bright steps per code must be from 1 to the length, minimum first");
+  }
+}
+
+CyclicCodeSearch::CyclicCodeSearch(CodeConstraints const &constraints, int threads)
+    : constraints_(constraints), pool_(threads) {
+  constraints_.validate();
+  auto length = constraints_.length;
+  allSteps_ = length == PatternSet::WORD_BITS ? ~Word(0) : (Word(1) << length) - 1;
+  for (int weight = constraints_.minWeight; weight <= constraints_.maxWeight; ++weight) {
+    // Every code of this weight in increasing order (Gosper's hack), keeping
+    // the lowest of each set of rotations.
+    auto code = allSteps_ >> (length - weight);
+    while (true) {
+      bool lowest = true;
+      for (int r = 1; r < length && lowest; ++r) {
+        lowest = rotate(code, r, length) >= code;
+      }
+      if (lowest) {
+        candidates_.push_back(code);
+      }
+      auto lowBit = code & (~code + 1);
+      auto ripple = code + lowBit;
+      if (ripple == 0 || (ripple & ~allSteps_) != 0) {
+        break;
+      }
+      code = (((ripple ^ code) >> 2) / lowBit) | ripple;
+    }
+  }
+}
+
+void CyclicCodeSearch::avoid(PatternSet const &codes) {
+  if (codes.stepCount() != constraints_.length) {
+    throw std::invalid_argument("Codes to avoid must be as long as the codes searched for");
+  }
+  auto tooClose = [&](Word candidate) {
+    for (int led = 0; led < codes.ledCount(); ++led) {
+      if (cyclicDistance(candidate, codes.code(led), constraints_.length) < constraints_.minDistance) {
+        return true;
+      }
+    }
+    return false;
+  };
+  candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(), tooClose), candidates_.end());
+}
+
+CyclicCodeSearch::Word CyclicCodeSearch::rotate(Word code, int steps, int length) {
+  steps %= length;
+  if (steps == 0) {
+    return code;
+  }
+  auto mask = length == PatternSet::WORD_BITS ? ~Word(0) : (Word(1) << length) - 1;
+  return ((code << steps) | (code >> (length - steps))) & mask;
+}
+
+int CyclicCodeSearch::cyclicDistance(Word a, Word b, int length) {
+  auto ret = length;
+  for (int r = 0; r < length; ++r) {
+    ret = std::min(ret, PatternSet::popcount(a ^ rotate(b, r, length)));
+  }
+  return ret;
+}
+
+bool CyclicCodeSearch::run(double seconds) {
+  deadline_ = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+  nodes_ = 0;
+  restarts_ = 0;
+  gaveUp_ = false;
+  // Every range of weights, widest first.
+  std::vector<std::pair<int, int>> weights;
+  for (int width = constraints_.maxWeight - constraints_.minWeight; width >= 0; --width) {
+    for (int low = constraints_.minWeight; low + width <= constraints_.maxWeight; ++low) {
+      weights.emplace_back(low, low + width);
+    }
+  }
+  for (auto maxNodes = FIRST_RESTART_NODES; !weights.empty(); maxNodes *= 2) {
+    for (std::size_t i = 0; i < weights.size();) {
+      auto range = weights[i];
+      if (restart(range.first, range.second, maxNodes)) {
+        codes_ = PatternSet(constraints_.codeCount, constraints_.length);
+        for (std::size_t led = 0; led < bestPlaced_.size(); ++led) {
+          PatternSet::forEachBit(&bestPlaced_[led], 1,
+                                 [&](int step) { codes_.set(static_cast<int>(led), step, true); });
+        }
+        return true;
+      }
+      if (stopped_) {
+        if (std::chrono::steady_clock::now() > deadline_) {
+          gaveUp_ = true;
+          return false;
+        }
+        ++i;
+        continue;
+      }
+      // Every candidate tried: nor is there a set within any narrower range -
+      // all of them after this one.
+      weights.erase(std::remove_if(weights.begin() + i, weights.end(),
+                                   [&](std::pair<int, int> const &w) {
+                                     return w.first >= range.first && w.second <= range.second;
+                                   }),
+                    weights.end());
+    }
+  }
+  return false;
+}
+
+bool CyclicCodeSearch::restart(int minWeight, int maxWeight, long long maxNodes) {
+  ++restarts_;
+  maxNodes_ = maxNodes;
+  nodesBefore_ = nodes_;
+  found_ = false;
+  stopped_ = false;
+  bestPath_.clear();
+  bestPlaced_.clear();
+  auto root = std::make_shared<Partial>();
+  root->load.assign(constraints_.length, 0);
+  for (int i = 0; i < candidateCount(); ++i) {
+    auto weight = PatternSet::popcount(candidates_[i]);
+    if (weight >= minWeight && weight <= maxWeight) {
+      root->open.push_back(i);
+    }
+  }
+  pool_.push([this, root] { explore(*root); });
+  pool_.run();
+  return found_;
+}
+
+void CyclicCodeSearch::explore(Partial const &partial) {
+  if (++nodes_ - nodesBefore_ > maxNodes_ || std::chrono::steady_clock::now() > deadline_) {
+    stopped_ = true;
+  }
+  if (stopped_) {
+    return;
+  }
+  auto needed = static_cast<std::size_t>(constraints_.codeCount) - partial.path.size();
+  if (needed == 0) {
+    offer(partial);
+    return;
+  }
+  if (partial.open.size() < needed) {
+    return;
+  }
+  // Too little room left at the steps for even the lightest codes that could
+  // still join? The candidates go lightest first.
+  long long spare = 0;
+  for (auto load : partial.load) {
+    spare += constraints_.maxBrightPerStep - load;
+  }
+  for (std::size_t i = 0; i < needed && spare >= 0; ++i) {
+    spare -= PatternSet::popcount(candidates_[partial.open[i]]);
+  }
+  if (spare < 0) {
+    return;
+  }
+  if (partial.path.size() < SPLIT_DEPTH) {
+    expandFrom(std::make_shared<Partial>(partial), 0);
+    return;
+  }
+  for (std::size_t i = 0; i + needed <= partial.open.size(); ++i) {
+    if (stopped_ || beaten(partial, partial.open[i])) {
+      return;
+    }
+    auto rotation = bestRotation(candidates_[partial.open[i]], constraints_.length, partial.load,
+                                 constraints_.maxBrightPerStep);
+    if (rotation >= 0) {
+      explore(child(partial, i, rotation));
+    }
+  }
+}
+
+void CyclicCodeSearch::expandFrom(PartialPtr const &parent, std::size_t from) {
+  auto needed = static_cast<std::size_t>(constraints_.codeCount) - parent->path.size();
+  for (auto i = from; i + needed <= parent->open.size(); ++i) {
+    if (stopped_ || beaten(*parent, parent->open[i])) {
+      return;
+    }
+    auto rotation = bestRotation(candidates_[parent->open[i]], constraints_.length, parent->load,
+                                 constraints_.maxBrightPerStep);
+    if (rotation < 0) {
+      continue;
+    }
+    // The later siblings, for this thread to take up next unless another
+    // steals them first; then this one, depth first.
+    pool_.push([this, parent, i] { expandFrom(parent, i + 1); });
+    explore(child(*parent, i, rotation));
+    return;
+  }
+}
+
+int CyclicCodeSearch::bestRotation(Word code, int length, std::vector<int> const &load, int maxBrightPerStep) {
+  auto ret = -1;
+  int bestBusiest = 0;
+  int bestSum = 0;
+  for (int r = 0; r < length; ++r) {
+    auto rotated = rotate(code, r, length);
+    int busiest = 0;
+    int sum = 0;
+    PatternSet::forEachBit(&rotated, 1, [&](int step) {
+      busiest = std::max(busiest, load[step]);
+      sum += load[step];
+    });
+    if (busiest >= maxBrightPerStep) {
+      continue;
+    }
+    if (ret < 0 || busiest < bestBusiest || (busiest == bestBusiest && sum < bestSum)) {
+      ret = r;
+      bestBusiest = busiest;
+      bestSum = sum;
+    }
+  }
+  return ret;
+}
+
+CyclicCodeSearch::Partial CyclicCodeSearch::child(Partial const &parent, std::size_t index, int rotation) const {
+  auto length = constraints_.length;
+  auto candidate = parent.open[index];
+  auto code = candidates_[candidate];
+  Partial ret;
+  ret.path = parent.path;
+  ret.path.push_back(candidate);
+  ret.placed = parent.placed;
+  ret.placed.push_back(rotate(code, rotation, length));
+  ret.load = parent.load;
+  PatternSet::forEachBit(&ret.placed.back(), 1, [&](int step) { ++ret.load[step]; });
+
+  std::vector<Word> rotations;
+  for (int r = 0; r < length; ++r) {
+    rotations.push_back(rotate(code, r, length));
+  }
+  for (auto it = parent.open.begin() + index + 1; it != parent.open.end(); ++it) {
+    auto other = candidates_[*it];
+    auto farEnough = std::all_of(rotations.begin(), rotations.end(), [&](Word rotated) {
+      return PatternSet::popcount(other ^ rotated) >= constraints_.minDistance;
+    });
+    if (farEnough) {
+      ret.open.push_back(*it);
+    }
+  }
+  return ret;
+}
+
+bool CyclicCodeSearch::beaten(Partial const &parent, int next) const {
+  if (!found_) {
+    return false;
+  }
+  // Sets are found in increasing order of their candidates on one thread: a
+  // set found elsewhere, before anything this child could lead to, wins - and
+  // so it does over every later sibling.
+  std::lock_guard<std::mutex> lock(bestMutex_);
+  auto depth = parent.path.size();
+  auto mismatch = std::mismatch(parent.path.begin(), parent.path.end(), bestPath_.begin());
+  if (mismatch.first != parent.path.end()) {
+    return *mismatch.second < *mismatch.first;
+  }
+  return bestPath_[depth] < next;
+}
+
+void CyclicCodeSearch::offer(Partial const &partial) {
+  std::lock_guard<std::mutex> lock(bestMutex_);
+  if (!found_ || partial.path < bestPath_) {
+    bestPath_ = partial.path;
+    bestPlaced_ = partial.placed;
+    found_ = true;
+  }
+}
@@ -0,0 +1,154 @@
+/** @file
+    @brief Header for CyclicCodeSearch: finds a set of cyclic LED codes meeting
+   the tracker's constraints - distance under any rotation, brightness per code
+   and LEDs bright per step - by depth-first search on a WorkStealingPool.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_CyclicCodeSearch_h_GUID_4E9A2C17_B853_4F0D_96E2_0A7D51C3B8F6
+#define INCLUDED_CyclicCodeSearch_h_GUID_4E9A2C17_B853_4F0D_96E2_0A7D51C3B8F6
+
+// Internal Includes
+#include "PatternSet.h"
+#include "WorkStealingPool.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// What the tracker needs of a code set. It doesn't know an LED's phase, so
+/// codes are told apart under any rotation.
+struct CodeConstraints {
+  int codeCount;
+  /// Steps per code, up to PatternSet::WORD_BITS.
+  int length;
+  /// Steps two codes differ at, at least, however one is rotated against the
+  /// other - at least 1, so no code is a rotation of another.
+  int minDistance;
+  /// Codes bright at any one step, at most.
+  int maxBrightPerStep;
+  /// Bright steps per code.
+  int minWeight;
+  int maxWeight;
+
+  /// Throws std::invalid_argument on constraints that make no sense.
+  void validate() const;
+};
+
+/// Candidates are the codes of each allowed weight, one per set of rotations,
+/// lightest and then lowest first. The search picks them in that order, each
+/// rotated to the phase that loads the busiest steps least, so the first set
+/// found is the same on any number of threads. Only that phase is tried, so
+/// running out of candidates doesn't prove there's no such set.
+///
+/// The search can sink into a subtree with no set in it: e.g. every light code
+/// picked first, leaving only heavy ones that overload the steps. So it's run in
+/// rounds of restarts, each limited to a number of partial sets doubling every
+/// round: over all the weights first, then over each narrower range of them.
+/// Which restart finds a set can then depend on the thread count.
+class CyclicCodeSearch {
+public:
+  using Word = PatternSet::Word;
+
+  /// With no thread count, one per hardware thread. Throws
+  /// std::invalid_argument on invalid constraints.
+  explicit CyclicCodeSearch(CodeConstraints const &constraints, int threads = 0);
+
+  /// Drops the candidates closer than the minimum distance to any of these
+  /// codes (of the same length), under any rotation - e.g. codes already in use
+  /// by another device. Call before run().
+  void avoid(PatternSet const &codes);
+
+  /// Searches until a set is found, the candidates run out or the seconds have
+  /// passed. Returns whether a set was found.
+  bool run(double seconds);
+
+  /// The codes found, one LED each, at their chosen phase.
+  PatternSet const &codes() const { return codes_; }
+  int candidateCount() const { return static_cast<int>(candidates_.size()); }
+  /// Partial sets tried, over every restart.
+  long long nodes() const { return nodes_; }
+  int restarts() const { return restarts_; }
+  /// Whether run() stopped on the time limit rather than trying every candidate.
+  bool gaveUp() const { return gaveUp_; }
+  int threadCount() const { return pool_.threadCount(); }
+
+  /// The code rotated to start steps later, within length steps.
+  static Word rotate(Word code, int steps, int length);
+  /// The fewest steps the codes differ at, under any rotation of one of them.
+  static int cyclicDistance(Word a, Word b, int length);
+  /// The phase of the code (steps to rotate it) that keeps every step within
+  /// maxBrightPerStep, given the codes bright at each so far, and adds least
+  /// to the busiest; -1 if none does.
+  static int bestRotation(Word code, int length, std::vector<int> const &load, int maxBrightPerStep);
+
+private:
+  /// A partial set: the candidates picked, in increasing order, their phases
+  /// and the candidates after the last that could still join it.
+  struct Partial {
+    std::vector<int> path;
+    std::vector<Word> placed;
+    std::vector<int> load;
+    std::vector<int> open;
+  };
+  using PartialPtr = std::shared_ptr<Partial const>;
+
+  /// Searches the candidates of weights from minWeight to maxWeight, trying at
+  /// most maxNodes partial sets. Returns whether a set was found.
+  bool restart(int minWeight, int maxWeight, long long maxNodes);
+  void explore(Partial const &partial);
+  void expandFrom(PartialPtr const &parent, std::size_t from);
+  Partial child(Partial const &parent, std::size_t index, int rotation) const;
+  /// Whether a set already found comes before any the child with the next
+  /// candidate could lead to.
+  bool beaten(Partial const &parent, int next) const;
+  void offer(Partial const &partial);
+
+  CodeConstraints constraints_;
+  Word allSteps_;
+  std::vector<Word> candidates_;
+  std::chrono::steady_clock::time_point deadline_;
+  long long maxNodes_ = 0;
+  /// nodes_ when the restart began.
+  long long nodesBefore_ = 0;
+  std::atomic<long long> nodes_{0};
+  int restarts_ = 0;
+  std::atomic<bool> found_{false};
+  /// The restart stopped on its node limit or the deadline.
+  std::atomic<bool> stopped_{false};
+  bool gaveUp_ = false;
+  std::vector<int> bestPath_;
+  std::vector<Word> bestPlaced_;
+  mutable std::mutex bestMutex_;
+  PatternSet codes_;
+  WorkStealingPool pool_;
+};
+
+#endif // INCLUDED_CyclicCodeSearch_h_GUID_4E9A2C17_B853_4F0D_96E2_0A7D51C3B8F6
@@ -0,0 +1,228 @@
+/** @file
+    @brief App that decodes the firmware's event trace ("LR" lines, see
+   User/trace.h) out of a console log into per-frame timelines, and sums up the
+   timing of each frame: sync to flash, upload durations, and the slack left
+   between an upload and the next process timer interrupt.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "trace.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+static const char *const EVENT_NAMES[] = {"sync", "lockout sync", "flash start", "process timer",
+                                          "upload start", "upload end", "command"};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == TRACE_EVENT_COUNT, "Name every trace event");
+
+struct Event {
+  int type;
+  int arg;
+  /// usec since the sync that started the frame
+  long us;
+};
+
+using Frame = std::vector<Event>;
+
+class Stat {
+public:
+  void add(long us) {
+    min_ = std::min(min_, us);
+    max_ = std::max(max_, us);
+    sum_ += us;
+    ++count_;
+  }
+  void print(std::string const &name) const {
+    std::cout << std::left << std::setw(28) << name << std::right;
+    if (count_ == 0) {
+      std::cout << "no samples\n";
+      return;
+    }
+    std::cout << "min " << std::setw(6) << min_ << "  mean " << std::setw(6) << sum_ / count_ << "  max "
+              << std::setw(6) << max_ << " usec  (" << count_ << " samples)\n";
+  }
+
+private:
+  long min_ = std::numeric_limits<long>::max();
+  long max_ = std::numeric_limits<long>::min();
+  long sum_ = 0;
+  long count_ = 0;
+};
+
+static int parseHex(std::string const &s, std::size_t pos, std::size_t len) {
+  return static_cast<int>(std::strtol(s.substr(pos, len).c_str(), nullptr, 16));
+}
+
+/// Parses one "LR:oo:eeaatttt,eeaatttt,..." line, appending its records.
+/// Returns false if the line isn't a trace line.
+static bool parseLine(std::string const &line, std::vector<Event> &events, long &lost) {
+  auto start = line.find("LR:");
+  if (start == std::string::npos || line.size() < start + 6 || line[start + 5] != ':') {
+    return false;
+  }
+  lost += parseHex(line, start + 3, 2);
+  for (auto pos = start + 6; pos + 8 <= line.size() && line[pos] != '\r'; pos += 9) {
+    Event e;
+    e.type = parseHex(line, pos, 2);
+    e.arg = parseHex(line, pos + 2, 2);
+    e.us = parseHex(line, pos + 4, 4) * long(TRACE_TICK_US);
+    if (e.type >= TRACE_EVENT_COUNT) {
+      std::cerr << "Unknown event type " << e.type << " in: " << line << std::endl;
+      continue;
+    }
+    events.push_back(e);
+  }
+  return true;
+}
+
+static std::vector<Frame> splitFrames(std::vector<Event> const &events) {
+  std::vector<Frame> frames;
+  for (auto const &e : events) {
+    if (e.type == TRACE_SYNC || frames.empty()) {
+      frames.emplace_back();
+    }
+    frames.back().push_back(e);
+  }
+  return frames;
+}
+
+static void printArg(Event const &e) {
+  switch (e.type) {
+  case TRACE_SYNC:
+    std::cout << (e.arg ? " (simulated)" : " (camera)");
+    break;
+  case TRACE_FLASH_START:
+    std::cout << " row " << e.arg;
+    break;
+  case TRACE_UPLOAD_START:
+  case TRACE_UPLOAD_END:
+    if (e.arg & TRACE_UPLOAD_GROUP) {
+      std::cout << " group " << (e.arg & ~TRACE_UPLOAD_GROUP);
+    } else if (e.arg & TRACE_UPLOAD_LEVEL) {
+      std::cout << " level row " << (e.arg & ~TRACE_UPLOAD_LEVEL);
+    } else {
+      std::cout << " row " << e.arg;
+    }
+    break;
+  case TRACE_COMMAND:
+    std::cout << " '" << static_cast<char>(e.arg) << "'";
+    break;
+  default:
+    std::cout << " " << e.arg;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <console log> [-v]\n"
+              << "Capture the log after e.g. LW:3F,1 (all but commands, streamed)." << std::endl;
+    return 1;
+  }
+  std::ifstream file(argv[1]);
+  if (!file) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  bool verbose = argc > 2 && std::string(argv[2]) == "-v";
+
+  std::vector<Event> events;
+  long lost = 0;
+  long lines = 0;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (parseLine(line, events, lost)) {
+      ++lines;
+    }
+  }
+  auto frames = splitFrames(events);
+  std::cout << events.size() << " records in " << lines << " trace lines, " << frames.size() << " frames, " << lost
+            << " records lost\n";
+  if (lost > 0) {
+    std::cout << "Frames missing records get skewed stats - trace fewer events (LW mask) to keep up.\n";
+  }
+
+  Stat syncToFlash, upload, slack;
+  long lockoutSyncs = 0;
+  for (auto const &frame : frames) {
+    if (verbose) {
+      std::cout << "\n";
+      for (auto const &e : frame) {
+        std::cout << std::setw(8) << e.us << "  " << EVENT_NAMES[e.type];
+        printArg(e);
+        std::cout << "\n";
+      }
+    }
+    // Without the sync, times are relative to one we didn't see.
+    bool synced = frame.front().type == TRACE_SYNC;
+    const Event *uploadStart = nullptr;
+    const Event *uploadEnd = nullptr;
+    for (auto const &e : frame) {
+      switch (e.type) {
+      case TRACE_LOCKOUT_SYNC:
+        ++lockoutSyncs;
+        break;
+      case TRACE_FLASH_START:
+        if (synced) {
+          syncToFlash.add(e.us - frame.front().us);
+        }
+        break;
+      case TRACE_UPLOAD_START:
+        uploadStart = &e;
+        break;
+      case TRACE_UPLOAD_END:
+        if (uploadStart && uploadStart->arg == e.arg) {
+          upload.add(e.us - uploadStart->us);
+        }
+        uploadStart = nullptr;
+        uploadEnd = &e;
+        break;
+      case TRACE_PROCESS_TIMER:
+        if (uploadEnd) {
+          slack.add(e.us - uploadEnd->us);
+        }
+        uploadEnd = nullptr;
+        break;
+      default:
+        break;
+      }
+    }
+  }
+  std::cout << "\nTimer resolution " << TRACE_TICK_US << " usec\n";
+  syncToFlash.print("Sync to flash start");
+  upload.print("Upload duration");
+  slack.print("Upload end to next timer");
+  std::cout << lockoutSyncs << " syncs ignored in the lockout" << std::endl;
+  return 0;
+}
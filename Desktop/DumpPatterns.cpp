@@ -26,7 +26,7 @@
 
 // Internal Includes
 #include "BeaconOrder.h"
-#include "PatternString.h"
+#include "PatternSet.h"
 #include "array_init.h"
 
 // Library/third-party includes
@@ -34,50 +34,42 @@
 #include <json/writer.h>
 
 // Standard includes
+#include <cstddef>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
-int main() {
-  default_array_init();
-#if 0
-    std::vector<std::string> patterns(NUM_LEDS);
-    for (int patternElement = 0; patternElement < PATTERN_COUNT; ++patternElement) {
-        for (int led = 0; led < NUM_LEDS; ++led) {
-            patterns[led] += (getBitFromPattern(patternElement, led) ? "*" : ".");
-        }
+int main(int argc, char *argv[]) {
+  if (argc > 1) {
+    auto bank = std::atoi(argv[1]);
+    if (!bank_array_init(static_cast<uint8_t>(bank), static_cast<uint8_t>(bank))) {
+      std::cerr << "Usage: " << argv[0] << " [pattern bank 0-" << (PATTERN_BANK_COUNT - 1) << "]" << std::endl;
+      return 1;
     }
-
-
-    for (int led = 0; led < NUM_LEDS; ++led) {
-        std::cout << "LED " << std::setw(2) << led << ": " << patterns[led]  << std::endl;
-    }
-#endif
-  for (int led = 0; led < NUM_LEDS; ++led) {
-    std::cout << "pattern_array LED " << std::setw(2) << led << ": " << getPatternString(led, pattern_array)
-              << std::endl;
+  } else {
+    default_array_init();
+  }
+  std::cout << "Pattern bank " << int(active_pattern_bank) << "\n";
+  auto patterns = PatternSet::fromPatternArray(active_pattern_rows);
+  for (int led = 0; led < patterns.ledCount(); ++led) {
+    std::cout << "pattern_array LED " << std::setw(2) << led << ": " << patterns.trackerString(led) << std::endl;
   }
   std::cout << "\n\n";
 
   {
+    // One-based tracker beacon IDs, each with its firmware LED's pattern.
     Json::Value root;
-    auto addBeacon = [&](int beaconId) {
+    auto order = combinedBeaconOrder();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      if (order[i] >= patterns.ledCount()) {
+        continue;
+      }
       Json::Value beacon;
-      beacon[std::to_string(beaconId)] = getPatternString(beaconId - 1, pattern_array);
+      beacon[std::to_string(i + 1)] = patterns.trackerString(order[i]);
       root.append(beacon);
-    };
-    for (auto beaconId : TARGET0_BEACON_ORDER) {
-      // root[std::to_string(beaconId)] = getPatternString(beaconId - 1,
-      // pattern_array);
-      addBeacon(beaconId);
-    }
-    for (auto beaconId : TARGET1_BEACON_ORDER) {
-      // root[std::to_string(beaconId)] = getPatternString(beaconId - 1,
-      // pattern_array);
-
-      addBeacon(beaconId);
     }
     std::ofstream of("beacons.json");
     if (of) {
@@ -86,9 +78,9 @@ int main() {
     }
   }
 
-  for (int elt = 0; elt < 2 * NUM_LEDS; ++elt) {
-    std::cout << "ir_led_driver_buffer " << std::setw(2) << elt << ": " << getPatternString(elt, ir_led_driver_buffer)
-              << std::endl;
+  auto frames = PatternSet::fromRows(active_driver_frames[0], DRIVER_BUFFER_LENGTH, PATTERN_COUNT, 2 * LED_COUNT);
+  for (int elt = 0; elt < frames.ledCount(); ++elt) {
+    std::cout << "ir_led_driver_buffer " << std::setw(2) << elt << ": " << frames.trackerString(elt) << std::endl;
   }
 
   return 0;
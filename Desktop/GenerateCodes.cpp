@@ -0,0 +1,194 @@
+/** @file
+    @brief App that generates a new set of LED codes - for another LED count or
+   code length - meeting the tracker's constraints, and prints it as the
+   firmware's pattern table and the tracker's pattern strings.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "BchCodeConstruction.h"
+#include "CyclicCodeSearch.h"
+#include "PatternSet.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Like the HDK's codes: 40 of 16 steps, at least 2 apart, 3 to 5 bright steps
+/// each - but up to 10 LEDs bright per step rather than its 8, which leaves
+/// the search too little room.
+static const CodeConstraints DEFAULT_CONSTRAINTS = {40, 16, 2, 10, 3, 5};
+/// Seconds to search before giving up.
+static const double MAX_SECONDS = 10.;
+/// Codewords to try with --bch before giving up - some seconds' worth.
+static const long long MAX_CODEWORDS = 100000000;
+
+static void printPatternArray(PatternSet const &codes) {
+  auto rowBytes = (codes.ledCount() + 7) / 8;
+  std::vector<uint8_t> rows(codes.stepCount() * rowBytes);
+  codes.toRows(rows.data(), rowBytes);
+  std::cout << "// array_init.c, for PATTERN_COUNT " << codes.stepCount() << " and LED_COUNT " << rowBytes * 8
+            << "\nstatic const uint8_t production_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =\n{\n";
+  for (int step = 0; step < codes.stepCount(); ++step) {
+    std::cout << "    {";
+    for (int b = 0; b < rowBytes; ++b) {
+      std::cout << (b == 0 ? "" : ",") << int(rows[step * rowBytes + b]);
+    }
+    std::cout << "}" << (step + 1 < codes.stepCount() ? "," : "") << "\n";
+  }
+  std::cout << "};\n\n";
+}
+
+static void printTrackerStrings(PatternSet const &codes) {
+  std::cout << "// Patterns.cpp\nconst std::vector<std::string> GENERATED_PATTERNS = {\n";
+  for (int led = 0; led < codes.ledCount(); ++led) {
+    std::cout << (led == 0 ? "" : "    ,\n") << "    \"" << codes.trackerString(led) << "\" // " << led + 1 << "\n";
+  }
+  std::cout << "};" << std::endl;
+}
+
+/// Checks the set found against the constraints from scratch.
+static bool meets(PatternSet const &codes, CodeConstraints const &constraints) {
+  if (codes.ledCount() != constraints.codeCount || codes.stepCount() != constraints.length) {
+    return false;
+  }
+  for (int step = 0; step < codes.stepCount(); ++step) {
+    if (codes.brightLeds(step) > constraints.maxBrightPerStep) {
+      return false;
+    }
+  }
+  for (int a = 0; a < codes.ledCount(); ++a) {
+    auto weight = codes.brightSteps(a);
+    if (weight < constraints.minWeight || weight > constraints.maxWeight) {
+      return false;
+    }
+    for (int b = a + 1; b < codes.ledCount(); ++b) {
+      if (CyclicCodeSearch::cyclicDistance(codes.code(a), codes.code(b), constraints.length) <
+          constraints.minDistance) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  auto constraints = DEFAULT_CONSTRAINTS;
+  int *fields[] = {&constraints.codeCount,        &constraints.length,    &constraints.minDistance,
+                   &constraints.maxBrightPerStep, &constraints.minWeight, &constraints.maxWeight};
+  int threads = 0;
+  bool bch = false;
+  bool disjoint = false;
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--bch") {
+      bch = true;
+    } else if (std::string(argv[i]) == "--disjoint") {
+      disjoint = true;
+    } else if (positional < 6) {
+      *fields[positional++] = std::atoi(argv[i]);
+    } else {
+      threads = std::atoi(argv[i]);
+      ++positional;
+    }
+  }
+  try {
+    if (positional > 7 || threads < 0) {
+      throw std::invalid_argument("Too many arguments");
+    }
+    if (disjoint && (bch || constraints.length != PATTERN_COUNT)) {
+      throw std::invalid_argument("--disjoint searches for codes of PATTERN_COUNT steps, without --bch");
+    }
+    constraints.validate();
+  } catch (std::invalid_argument const &e) {
+    std::cerr << e.what() << "\nUsage: " << argv[0]
+              << " [codes] [steps] [min distance] [max bright per step] [min bright steps] [max bright steps]"
+                 " [threads] [--bch] [--disjoint]\nDefaults: 40 16 2 10 3 5. With --bch, built from a BCH code of 2^m"
+                 " - 1 steps rather than searched for. With --disjoint, at least the distance from every code of the"
+                 " firmware's pattern banks, for another device in front of the same camera."
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << constraints.codeCount << " codes of " << constraints.length << " steps, at least "
+            << constraints.minDistance << " apart under rotation, " << constraints.minWeight << "-"
+            << constraints.maxWeight << " bright steps each, at most " << constraints.maxBrightPerStep
+            << " bright per step:\n";
+  auto start = std::chrono::steady_clock::now();
+  PatternSet codes;
+  if (bch) {
+    try {
+      BchCodeConstruction construction(constraints);
+      auto found = construction.run(MAX_CODEWORDS);
+      auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "BCH code of dimension " << construction.dimension() << ", generator 0x" << std::hex
+                << construction.generator() << std::dec << ": " << construction.codewordsTried()
+                << " codewords tried, " << seconds << " s.\n";
+      if (!found) {
+        std::cerr << "Only " << construction.codes().ledCount() << " rotation classes fit the constraints"
+                  << (construction.codewordsTried() < MAX_CODEWORDS ? "" : " before giving up")
+                  << " - try a lower distance or wider weights." << std::endl;
+        return 1;
+      }
+      codes = construction.codes();
+    } catch (std::invalid_argument const &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  } else {
+    CyclicCodeSearch search(constraints, threads);
+    if (disjoint) {
+      for (auto const &bank : pattern_banks) {
+        search.avoid(PatternSet::fromPatternArray(bank.patterns));
+      }
+    }
+    auto found = search.run(MAX_SECONDS);
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << search.candidateCount() << " candidates, " << search.nodes() << " nodes in " << search.restarts()
+              << " restarts, " << seconds << " s on " << search.threadCount() << " threads.\n";
+    if (!found) {
+      std::cerr << (search.gaveUp() ? "Gave up after " : "Ran out of candidates after ") << search.nodes()
+                << " partial sets - try looser constraints." << std::endl;
+      return 1;
+    }
+    codes = search.codes();
+  }
+  if (!meets(codes, constraints)) {
+    std::cerr << "The set found doesn't meet the constraints!" << std::endl;
+    return 1;
+  }
+  std::cout << "\n";
+  printPatternArray(codes);
+  printTrackerStrings(codes);
+  return 0;
+}
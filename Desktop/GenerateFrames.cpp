@@ -0,0 +1,147 @@
+/** @file
+    @brief App that generates User/driver_frames.c: the driver frames and masks
+   the firmware would expand at boot, as flash tables it can send as they are
+   (ENABLE_FLASH_FRAMES). With --check, fails if that file is out of date
+   instead, so the build catches pattern or mask edits that weren't regenerated.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+static_assert(PATTERN_BANK_COUNT == 6, "Name the new pattern bank below.");
+static const char *const BANK_NAMES[PATTERN_BANK_COUNT] = {"PATTERN_BANK_HDK1", "PATTERN_BANK_HDK2",
+                                                           "PATTERN_BANK_SYNC_TEST", "PATTERN_BANK_DEVICE2",
+                                                           "PATTERN_BANK_DEVICE3", "PATTERN_BANK_DEVICE4"};
+
+/// Firmware sources use CRLF line endings.
+static const char EOL[] = "\r\n";
+
+static void putRow(std::ostream &os, uint8_t const *row) {
+  os << "{";
+  for (int i = 0; i < DRIVER_BUFFER_LENGTH; ++i) {
+    os << (i ? ", " : "") << "0x" << std::hex << std::setw(2) << std::setfill('0') << int(row[i]) << std::dec;
+  }
+  os << "}";
+}
+
+static std::string generate() {
+  std::ostringstream os;
+  os << "/** @file" << EOL << "    @brief Driver frames precomputed from the pattern banks in array_init.c, for"
+     << EOL << "   ENABLE_FLASH_FRAMES." << EOL << EOL
+     << "    Generated by Desktop/GenerateFrames - don't edit, regenerate it after" << EOL
+     << "   changing the patterns or masks (the desktop build checks it's current)." << EOL << EOL << "    @date 2016"
+     << EOL << EOL << "    @author" << EOL << "    Sensics, Inc." << EOL << "    <http://sensics.com/osvr>" << EOL
+     << "*/" << EOL << EOL;
+  os << "/*" << EOL << "// Copyright 2016 Sensics, Inc." << EOL << "//" << EOL
+     << "// Licensed under the Apache License, Version 2.0 (the \"License\");" << EOL
+     << "// you may not use this file except in compliance with the License." << EOL
+     << "// You may obtain a copy of the License at" << EOL << "//" << EOL
+     << "//        http://www.apache.org/licenses/LICENSE-2.0" << EOL << "//" << EOL
+     << "// Unless required by applicable law or agreed to in writing, software" << EOL
+     << "// distributed under the License is distributed on an \"AS IS\" BASIS," << EOL
+     << "// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied." << EOL
+     << "// See the License for the specific language governing permissions and" << EOL
+     << "// limitations under the License." << EOL << "//" << EOL << "// SPDX-License-Identifier: Apache-2.0" << EOL
+     << "*/" << EOL << EOL;
+  os << "/* Internal Includes */" << EOL << "#include \"array_init.h\"" << EOL << "#include \"MCUConfig.h\"" << EOL
+     << EOL << "/* Library/third-party includes */" << EOL << "/* none */" << EOL << EOL << "/* Standard includes */"
+     << EOL << "/* none */" << EOL << EOL << "#ifdef ENABLE_FLASH_FRAMES" << EOL << EOL;
+  // Sized as generated, so they clash with the declarations in array_init.h if
+  // the table sizes change without regenerating.
+  os << "// clang-format off" << EOL << "/// The patterns of FLASH_FRAMES_BANK (" << BANK_NAMES[FLASH_FRAMES_BANK]
+     << "), expanded." << EOL << "const uint8_t flash_driver_frames[" << PATTERN_COUNT << "][" << DRIVER_BUFFER_LENGTH
+     << "] =" << EOL << "{" << EOL;
+  bank_array_init(FLASH_FRAMES_BANK, FLASH_FRAMES_BANK);
+  for (int i = 0; i < PATTERN_COUNT; ++i) {
+    os << "    ";
+    putRow(os, ir_led_driver_buffer[i]);
+    os << (i + 1 < PATTERN_COUNT ? "," : "") << EOL;
+  }
+  os << "};" << EOL << EOL;
+
+  os << "const uint8_t flash_driver_masks[" << PATTERN_BANK_COUNT << "][" << DRIVER_BUFFER_LENGTH << "] =" << EOL
+     << "{" << EOL;
+  for (int bank = 0; bank < PATTERN_BANK_COUNT; ++bank) {
+    bank_array_init(FLASH_FRAMES_BANK, static_cast<uint8_t>(bank));
+    os << "    /* " << BANK_NAMES[bank] << " */ ";
+    putRow(os, driver_mask);
+    os << (bank + 1 < PATTERN_BANK_COUNT ? "," : "") << EOL;
+  }
+  os << "};" << EOL << "// clang-format on" << EOL << EOL << "#endif // ENABLE_FLASH_FRAMES" << EOL;
+  return os.str();
+}
+
+static std::string withoutCarriageReturns(std::string text) {
+  text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+  return text;
+}
+
+int main(int argc, char *argv[]) {
+  bool check = argc > 1 && std::string(argv[1]) == "--check";
+  if (argc > 3 || (check && argc != 3)) {
+    std::cerr << "Usage: " << argv[0] << " [<driver_frames.c to write>]\n"
+              << "       " << argv[0] << " --check <driver_frames.c>" << std::endl;
+    return 1;
+  }
+  auto frames = generate();
+
+  if (check) {
+    std::ifstream file(argv[2], std::ios::binary);
+    if (!file) {
+      std::cerr << "Could not open " << argv[2] << std::endl;
+      return 1;
+    }
+    std::string existing{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (withoutCarriageReturns(existing) != withoutCarriageReturns(frames)) {
+      std::cerr << argv[2] << " is out of date - regenerate it with " << argv[0] << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (argc == 2) {
+    std::ofstream file(argv[1], std::ios::binary);
+    if (!file) {
+      std::cerr << "Could not open " << argv[1] << std::endl;
+      return 1;
+    }
+    file << frames;
+    return 0;
+  }
+  std::cout << frames;
+  return 0;
+}
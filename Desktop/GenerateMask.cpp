@@ -26,19 +26,14 @@
 
 // Internal Includes
 #include "BeaconOrder.h"
-#include "PatternString.h"
+#include "PatternSet.h"
 #include "array_init.h"
 
 // Library/third-party includes
 // - none
 
 // Standard includes
-#include <cstddef>
-#include <iomanip>
 #include <iostream>
-#include <string>
-#include <vector>
-#include <climits>
 
 /// 1-based indices WRT the tracking software of beacons we'd like to disable.
 #if 0
@@ -60,50 +55,23 @@ static const auto DISABLED_TARGET0_BEACONS = {
 /// 1-based indices WRT the tracking software of the beacons on the rear that never light up anyway.
 static const auto DISABLED_TARGET1_BEACONS = {1, 4};
 
-/// needs a bidirectional iterator
-template <typename Iterator> inline uint8_t byteFromBoolContainer(Iterator lsb) {
-  uint8_t ret = 0;
-  Iterator it = lsb;
-  // advancing one too far is OK because of the "one past the end" iterator.
-  std::advance(it, CHAR_BIT);
-  for (int count = CHAR_BIT; count != 0; --count) {
-    // can unconditionally move backwards because we moved it one too far.
-    --it;
-    if (*it) {
-      ret = ret << 1 | static_cast<uint8_t>(0x01);
-    } else {
-      ret = ret << 1;
-    }
-  }
-  return ret;
-}
-
-template <typename Container> inline uint8_t byteFromBoolContainerAtBit(Container &&c, std::size_t bit) {
-  auto it = begin(std::forward<Container>(c));
-  if (bit > 0) {
-    std::advance(it, bit);
-  }
-  return byteFromBoolContainer(it);
-}
-
-template <typename Container> inline uint8_t byteFromBoolContainerAtByte(Container &&c, std::size_t b) {
-  return byteFromBoolContainerAtBit(std::forward<Container>(c), b * CHAR_BIT);
-}
-
 int main() {
-  std::vector<bool> mask(NUM_LEDS, true);
+  // A single step, lit where the LED is enabled.
+  PatternSet mask(LED_COUNT, 1);
+  for (int led = 0; led < LED_COUNT; ++led) {
+    mask.set(led, 0, true);
+  }
   for (auto &beacon1based : DISABLED_TARGET0_BEACONS) {
-    auto bit = oneBasedTarget0BeaconToFirmwareBit(beacon1based);
-    mask[bit] = false;
+    mask.clearLed(oneBasedTarget0BeaconToFirmwareBit(beacon1based));
   }
 
   for (auto &beacon1based : DISABLED_TARGET1_BEACONS) {
-    auto bit = oneBasedTarget1BeaconToFirmwareBit(beacon1based);
-    mask[bit] = false;
+    mask.clearLed(oneBasedTarget1BeaconToFirmwareBit(beacon1based));
   }
 
-  for (int i = 0; i < LED_LINE_LENGTH; ++i) {
-    auto b = byteFromBoolContainerAtByte(mask, i);
+  uint8_t row[LED_LINE_LENGTH];
+  mask.toRows(row, LED_LINE_LENGTH);
+  for (auto b : row) {
     std::cout << "0x" << std::hex << static_cast<unsigned>(b) << ", ";
   }
   std::cout << std::endl;
@@ -0,0 +1,125 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MaskCost.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <stdexcept>
+
+MaskCost::MaskCost(CoBrightness const &coBrightness)
+    : neighbors_(coBrightness.ledCount()), masked_(coBrightness.ledCount(), false),
+      ledCost_(coBrightness.ledCount(), 0.), ledSteps_(coBrightness.ledCount(), 0) {
+  // Nearest first, a step at a time, so the starting sums are the ones
+  // BrightNeighbors gets from its sorted list.
+  for (auto const &pair : coBrightness.sortedPairs()) {
+    auto stepCost = coBrightness.stepCost(pair.a, pair.b);
+    double cost = 0.;
+    for (int i = 0; i < pair.count; ++i) {
+      cost += stepCost;
+      ledCost_[pair.a] += stepCost;
+      ledCost_[pair.b] += stepCost;
+      totalCost_ += stepCost;
+    }
+    neighbors_[pair.a].push_back(Neighbor{pair.b, pair.count, cost});
+    neighbors_[pair.b].push_back(Neighbor{pair.a, pair.count, cost});
+    ledSteps_[pair.a] += pair.count;
+    ledSteps_[pair.b] += pair.count;
+    totalSteps_ += pair.count;
+  }
+}
+
+std::vector<int> MaskCost::maskedLeds() const {
+  std::vector<int> ret;
+  for (int led = 0; led < ledCount(); ++led) {
+    if (masked_[led]) {
+      ret.push_back(led);
+    }
+  }
+  return ret;
+}
+
+void MaskCost::mask(int led) {
+  if (masked_[led]) {
+    throw std::logic_error("LED is already masked");
+  }
+  apply(led, true);
+}
+
+void MaskCost::unmask(int led) {
+  if (!masked_[led]) {
+    throw std::logic_error("LED isn't masked");
+  }
+  apply(led, false);
+}
+
+void MaskCost::apply(int led, bool mask) {
+  Change change{led, totalCost_, totalSteps_, {}};
+  change.neighborCosts.reserve(neighbors_[led].size());
+  auto sign = mask ? -1 : 1;
+  totalCost_ += sign * ledCost_[led];
+  totalSteps_ += sign * ledSteps_[led];
+  // Whether or not they're masked themselves, the neighbors' shares gain or
+  // lose this LED.
+  for (auto const &neighbor : neighbors_[led]) {
+    change.neighborCosts.push_back(ledCost_[neighbor.led]);
+    ledCost_[neighbor.led] += sign * neighbor.cost;
+    ledSteps_[neighbor.led] += sign * neighbor.steps;
+  }
+  masked_[led] = mask;
+  history_.push_back(std::move(change));
+}
+
+void MaskCost::undo() {
+  if (history_.empty()) {
+    throw std::logic_error("Nothing to undo");
+  }
+  auto const &change = history_.back();
+  auto led = change.led;
+  auto sign = masked_[led] ? 1 : -1;
+  totalCost_ = change.totalCost;
+  totalSteps_ = change.totalSteps;
+  auto const &neighbors = neighbors_[led];
+  for (std::size_t i = 0; i < neighbors.size(); ++i) {
+    ledCost_[neighbors[i].led] = change.neighborCosts[i];
+    ledSteps_[neighbors[i].led] += sign * neighbors[i].steps;
+  }
+  masked_[led] = !masked_[led];
+  history_.pop_back();
+}
+
+std::vector<double> MaskCost::costIfMasked() const {
+  std::vector<double> ret(ledCount(), totalCost_);
+  for (int led = 0; led < ledCount(); ++led) {
+    if (!masked_[led]) {
+      ret[led] -= ledCost_[led];
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,100 @@
+/** @file
+    @brief Header for MaskCost: BrightNeighbors' costs for a set of masked
+   LEDs, kept up to date as LEDs are masked, unmasked and the changes undone,
+   each in time proportional to the LED's co-bright neighbors.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_MaskCost_h_GUID_E5A07C3D_8F19_4B62_9D4E_1C73B68A2F05
+#define INCLUDED_MaskCost_h_GUID_E5A07C3D_8F19_4B62_9D4E_1C73B68A2F05
+
+// Internal Includes
+#include "CoBrightness.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <vector>
+
+class MaskCost {
+public:
+  /// Starts with no LEDs masked.
+  explicit MaskCost(CoBrightness const &coBrightness);
+
+  int ledCount() const { return static_cast<int>(masked_.size()); }
+  bool isMasked(int led) const { return masked_[led]; }
+  std::vector<int> maskedLeds() const;
+
+  /// Mask (make always dim) or unmask an LED. Throws std::logic_error if it
+  /// already is.
+  void mask(int led);
+  void unmask(int led);
+  /// Reverts the last mask or unmask that hasn't been undone yet, restoring
+  /// the costs exactly. Throws std::logic_error if there is none.
+  void undo();
+  std::size_t undoDepth() const { return history_.size(); }
+
+  /// Over the pairs of unmasked LEDs: the cost of the steps they're bright
+  /// together, and how many such steps.
+  double totalCost() const { return totalCost_; }
+  int totalSteps() const { return totalSteps_; }
+
+  /// The LED's share with the unmasked LEDs: what it adds to the totals while
+  /// unmasked, or would add if unmasked.
+  double ledCost(int led) const { return ledCost_[led]; }
+  int ledSteps(int led) const { return ledSteps_[led]; }
+
+  /// The total cost if each LED were masked too (the current total for those
+  /// already masked), for all of them at once.
+  std::vector<double> costIfMasked() const;
+
+private:
+  struct Neighbor {
+    int led;
+    int steps;
+    double cost;
+  };
+  void apply(int led, bool mask);
+
+  std::vector<std::vector<Neighbor>> neighbors_;
+  std::vector<bool> masked_;
+  std::vector<double> ledCost_;
+  std::vector<int> ledSteps_;
+  double totalCost_ = 0.;
+  int totalSteps_ = 0;
+
+  /// What a mask or unmask changed, to put back on undo.
+  struct Change {
+    int led;
+    double totalCost;
+    int totalSteps;
+    /// The neighbors' costs before, in neighbors_ order.
+    std::vector<double> neighborCosts;
+  };
+  std::vector<Change> history_;
+};
+
+#endif // INCLUDED_MaskCost_h_GUID_E5A07C3D_8F19_4B62_9D4E_1C73B68A2F05
@@ -0,0 +1,259 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MaskSearch.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+MaskSearch::MaskSearch(MaskCost const &base, int count, int threads)
+    : base_(base), count_(count), baseDepth_(base.undoDepth()), bestCost_(std::numeric_limits<double>::infinity()),
+      pool_(threads) {
+  for (int led = 0; led < base.ledCount(); ++led) {
+    if (!base.isMasked(led)) {
+      candidates_.push_back(led);
+    }
+  }
+  std::stable_sort(candidates_.begin(), candidates_.end(),
+                   [&](int a, int b) { return base.ledCost(a) > base.ledCost(b); });
+  states_.assign(pool_.threadCount(), base);
+  nodes_.assign(pool_.threadCount(), 0);
+}
+
+void MaskSearch::requireCoverage(std::vector<int> const &regions, int minActive) {
+  regions_ = regions;
+  minActive_ = minActive;
+  regionActive_.clear();
+  for (auto led : candidates_) {
+    auto region = regions_[led];
+    if (region >= static_cast<int>(regionActive_.size())) {
+      regionActive_.resize(region + 1, 0);
+    }
+    if (region >= 0) {
+      ++regionActive_[region];
+    }
+  }
+}
+
+bool MaskSearch::run() {
+  auto slack = regionSlack(Mask{});
+  if (std::any_of(slack.begin(), slack.end(), [](int s) { return s < 0; }) ||
+      bound(base_, Mask{}, 0, count_) == std::numeric_limits<double>::infinity()) {
+    return false;
+  }
+  auto seed = greedyWithinCoverage();
+  if (static_cast<int>(seed.size()) == count_) {
+    offer(costOf(base_, seed), seed);
+  }
+  pushTask(Mask{}, 0);
+  pool_.run();
+  return static_cast<int>(best_.size()) == count_;
+}
+
+long long MaskSearch::nodes() const {
+  long long ret = 0;
+  for (auto n : nodes_) {
+    ret += n;
+  }
+  return ret;
+}
+
+double MaskSearch::costOf(MaskCost base, Mask mask) {
+  std::sort(mask.begin(), mask.end());
+  for (auto led : mask) {
+    base.mask(led);
+  }
+  return base.totalCost();
+}
+
+MaskSearch::Mask MaskSearch::greedy(MaskCost maskCost, int count) {
+  Mask ret;
+  for (int i = 0; i < count; ++i) {
+    int chosen = -1;
+    for (int led = 0; led < maskCost.ledCount(); ++led) {
+      if (maskCost.isMasked(led) || maskCost.ledSteps(led) == 0) {
+        continue;
+      }
+      if (chosen < 0 || maskCost.ledCost(led) > maskCost.ledCost(chosen) ||
+          (maskCost.ledCost(led) == maskCost.ledCost(chosen) && maskCost.ledSteps(led) >= maskCost.ledSteps(chosen))) {
+        chosen = led;
+      }
+    }
+    if (chosen < 0) {
+      break;
+    }
+    maskCost.mask(chosen);
+    ret.push_back(chosen);
+  }
+  return ret;
+}
+
+MaskSearch::Mask MaskSearch::greedyWithinCoverage() const {
+  auto maskCost = base_;
+  Mask ret;
+  for (int i = 0; i < count_; ++i) {
+    int chosen = -1;
+    for (auto led : candidates_) {
+      if (maskCost.isMasked(led) || !coverageAllows(ret, led)) {
+        continue;
+      }
+      if (chosen < 0 || maskCost.ledCost(led) > maskCost.ledCost(chosen)) {
+        chosen = led;
+      }
+    }
+    if (chosen < 0) {
+      break;
+    }
+    maskCost.mask(chosen);
+    ret.push_back(chosen);
+  }
+  return ret;
+}
+
+bool MaskSearch::coverageAllows(Mask const &chosen, int led) const {
+  if (regions_.empty() || regions_[led] < 0) {
+    return true;
+  }
+  return regionSlack(chosen)[regions_[led]] > 0;
+}
+
+std::vector<int> MaskSearch::regionSlack(Mask const &chosen) const {
+  std::vector<int> ret;
+  for (auto active : regionActive_) {
+    ret.push_back(active - minActive_);
+  }
+  for (auto led : chosen) {
+    if (regions_[led] >= 0) {
+      --ret[regions_[led]];
+    }
+  }
+  return ret;
+}
+
+void MaskSearch::pushTask(Mask chosen, int next) {
+  pool_.push([this, chosen, next] {
+    auto &state = states_[WorkStealingPool::currentThread()];
+    while (state.undoDepth() > baseDepth_) {
+      state.undo();
+    }
+    for (auto led : chosen) {
+      state.mask(led);
+    }
+    auto path = chosen;
+    explore(state, path, next);
+  });
+}
+
+/// Levels of the search tree handed to the pool as separate tasks - below
+/// them, a task searches its subtree depth first on one thread.
+static const int SPLIT_DEPTH = 8;
+
+void MaskSearch::explore(MaskCost &state, Mask &chosen, int next) {
+  ++nodes_[WorkStealingPool::currentThread()];
+  auto remaining = count_ - static_cast<int>(chosen.size());
+  if (remaining == 0) {
+    offer(state.totalCost(), chosen);
+    return;
+  }
+  // Infinite when too few beacons are left to mask, within the coverage.
+  auto lowest = bound(state, chosen, next, remaining);
+  if (lowest == std::numeric_limits<double>::infinity() || lowest > bestCost_) {
+    return;
+  }
+  auto led = candidates_[next];
+  auto canMask = coverageAllows(chosen, led);
+  if (next < SPLIT_DEPTH) {
+    // The pool runs the last pushed first: masking this beacon, then not.
+    pushTask(chosen, next + 1);
+    if (canMask) {
+      auto with = chosen;
+      with.push_back(led);
+      pushTask(std::move(with), next + 1);
+    }
+    return;
+  }
+  if (canMask) {
+    state.mask(led);
+    chosen.push_back(led);
+    explore(state, chosen, next + 1);
+    chosen.pop_back();
+    state.undo();
+  }
+  explore(state, chosen, next + 1);
+}
+
+double MaskSearch::bound(MaskCost const &state, Mask const &chosen, int next, int remaining) const {
+  std::vector<int> order(candidates_.begin() + next, candidates_.end());
+  if (static_cast<int>(order.size()) < remaining) {
+    return std::numeric_limits<double>::infinity();
+  }
+  auto ret = state.totalCost();
+  if (regions_.empty()) {
+    std::nth_element(order.begin(), order.begin() + (remaining - 1), order.end(),
+                     [&](int a, int b) { return state.ledCost(a) > state.ledCost(b); });
+    for (int i = 0; i < remaining; ++i) {
+      ret -= state.ledCost(order[i]);
+    }
+    return ret;
+  }
+  // With coverage, the most expensive shares each region can still give up.
+  std::sort(order.begin(), order.end(), [&](int a, int b) { return state.ledCost(a) > state.ledCost(b); });
+  auto slack = regionSlack(chosen);
+  for (auto led : order) {
+    if (remaining == 0) {
+      break;
+    }
+    auto region = regions_[led];
+    if (region >= 0 && slack[region] <= 0) {
+      continue;
+    }
+    if (region >= 0) {
+      --slack[region];
+    }
+    ret -= state.ledCost(led);
+    --remaining;
+  }
+  return remaining == 0 ? ret : std::numeric_limits<double>::infinity();
+}
+
+void MaskSearch::offer(double cost, Mask mask) {
+  if (cost > bestCost_) {
+    return;
+  }
+  std::sort(mask.begin(), mask.end());
+  std::lock_guard<std::mutex> lock(bestMutex_);
+  // Ties go to the lowest beacons, whichever thread finds them first.
+  if (cost < bestCost_ || best_.empty() || (cost == bestCost_ && mask < best_)) {
+    bestCost_ = cost;
+    best_ = std::move(mask);
+  }
+}
@@ -0,0 +1,107 @@
+/** @file
+    @brief Header for MaskSearch: the exact best set of beacons to mask under
+   BrightNeighbors' distance cost, by branch and bound on a WorkStealingPool,
+   optionally keeping a minimum of LEDs lit in each region of the target.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_MaskSearch_h_GUID_71C3E8A5_2F64_4B9D_A017_5D8E3B92C6F4
+#define INCLUDED_MaskSearch_h_GUID_71C3E8A5_2F64_4B9D_A017_5D8E3B92C6F4
+
+// Internal Includes
+#include "MaskCost.h"
+#include "WorkStealingPool.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/// Branch and bound over the unmasked beacons, each either masked or not, most
+/// expensive first. A subtree is cut when even masking its most expensive
+/// remaining beacons couldn't beat the best mask so far: masking a beacon
+/// removes at most its current share of the cost. With coverage required, only
+/// as many of each region's as it can spare count.
+class MaskSearch {
+public:
+  /// Zero-based LEDs.
+  using Mask = std::vector<int>;
+
+  /// Searches for the count beacons to mask, besides those masked in base,
+  /// leaving the least total cost. With no thread count, one per hardware
+  /// thread.
+  MaskSearch(MaskCost const &base, int count, int threads = 0);
+
+  /// Only considers masks leaving at least minActive unmasked LEDs in each
+  /// region: regions[led] numbers the LED's region from 0, or is negative for
+  /// none.
+  void requireCoverage(std::vector<int> const &regions, int minActive);
+
+  /// Seeds the search with the greedy mask (within the coverage requirement)
+  /// and runs it. Returns false if no mask meets the requirement.
+  bool run();
+
+  int threadCount() const { return pool_.threadCount(); }
+  /// Sorted; ties go to the lowest beacons.
+  Mask const &best() const { return best_; }
+  double bestCost() const { return bestCost_; }
+  long long nodes() const;
+
+  /// The total cost with the LEDs masked too, from scratch in increasing
+  /// order, so masks reached in different orders compare fairly.
+  static double costOf(MaskCost base, Mask mask);
+  /// BrightNeighbors' choice, a round at a time: the beacon with the highest
+  /// total cost, then the most co-bright steps, then the highest ID.
+  static Mask greedy(MaskCost maskCost, int count);
+
+private:
+  Mask greedyWithinCoverage() const;
+  bool coverageAllows(Mask const &chosen, int led) const;
+  void pushTask(Mask chosen, int next);
+  void explore(MaskCost &state, Mask &chosen, int next);
+  std::vector<int> regionSlack(Mask const &chosen) const;
+  double bound(MaskCost const &state, Mask const &chosen, int next, int remaining) const;
+  void offer(double cost, Mask mask);
+
+  MaskCost base_;
+  int count_;
+  std::size_t baseDepth_;
+  std::vector<int> candidates_;
+  std::vector<int> regions_;
+  /// Unmasked LEDs in each region, in base.
+  std::vector<int> regionActive_;
+  int minActive_ = 0;
+  Mask best_;
+  std::atomic<double> bestCost_;
+  std::mutex bestMutex_;
+  WorkStealingPool pool_;
+  std::vector<MaskCost> states_;
+  std::vector<long long> nodes_;
+};
+
+#endif // INCLUDED_MaskSearch_h_GUID_71C3E8A5_2F64_4B9D_A017_5D8E3B92C6F4
@@ -28,7 +28,7 @@
 // SPDX-License-Identifier: Apache 2.0
 
 // Internal Includes
-#include "PatternString.h"
+#include "PatternSet.h"
 #include "Patterns.h"
 #include "array_init.h"
 
@@ -36,20 +36,9 @@
 // - none
 
 // Standard includes
-#include <algorithm>
-#include <iomanip>
 #include <iostream>
-#include <iterator>
 #include <vector>
 
-int findPattern(std::vector<std::string> const &patternList, std::string const &pattern) {
-  auto it = std::find(begin(patternList), end(patternList), pattern);
-  if (it == end(patternList)) {
-    return -1;
-  }
-  return std::distance(begin(patternList), it);
-}
-
 void dumpBeaconOrder(int targetNum, std::vector<int> const &order) {
   std::cout << "static const auto TARGET" << targetNum << "_BEACON_ORDER = {\n";
 
@@ -61,23 +50,25 @@ void dumpBeaconOrder(int targetNum, std::vector<int> const &order) {
 
 int main() {
   default_array_init();
-  initPatterns();
-  std::vector<int> targetOrder0(OsvrHdkLedIdentifier_SENSOR0_PATTERNS.size(), -1);
-  std::vector<int> targetOrder1(OsvrHdkLedIdentifier_SENSOR1_PATTERNS.size(), -1);
-  for (int led = 0; led < NUM_LEDS; ++led) {
-    auto patternString = getPatternString(led, pattern_array);
-    auto target0 = findPattern(OsvrHdkLedIdentifier_SENSOR0_PATTERNS, patternString);
-    if (target0 < 0) {
-      auto target1 = findPattern(OsvrHdkLedIdentifier_SENSOR1_PATTERNS, patternString);
-      if (target1 < 0) {
-        std::cout << "Could not find a match for firmware pattern " << led << ": " << patternString << std::endl;
+  auto firmware = PatternSet::fromPatternArray(active_pattern_rows);
+  auto target0 = hdkSensor0Patterns();
+  auto target1 = hdkSensor1Patterns();
+  std::vector<int> targetOrder0(target0.ledCount(), -1);
+  std::vector<int> targetOrder1(target1.ledCount(), -1);
+  for (int led = 0; led < firmware.ledCount(); ++led) {
+    auto beacon0 = target0.findLed(firmware, led);
+    if (beacon0 < 0) {
+      auto beacon1 = target1.findLed(firmware, led);
+      if (beacon1 < 0) {
+        std::cout << "Could not find a match for firmware pattern " << led << ": " << firmware.trackerString(led)
+                  << std::endl;
       } else {
-        std::cout << "Firmware pattern " << led << " is rear target pattern " << target1 << std::endl;
-        targetOrder1[target1] = led;
+        std::cout << "Firmware pattern " << led << " is rear target pattern " << beacon1 << std::endl;
+        targetOrder1[beacon1] = led;
       }
     } else {
-      std::cout << "Firmware pattern " << led << " is front target pattern " << target0 << std::endl;
-      targetOrder0[target0] = led;
+      std::cout << "Firmware pattern " << led << " is front target pattern " << beacon0 << std::endl;
+      targetOrder0[beacon0] = led;
     }
   }
   dumpBeaconOrder(0, targetOrder0);
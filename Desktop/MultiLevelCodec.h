@@ -0,0 +1,143 @@
+/** @file
+    @brief Header for the desktop side of multi-level brightness: maps per-LED
+   level codes (one symbol of 0-3 per frame) to the pattern and level plane
+   tables the firmware pulses, and measured brightness back to symbols.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_MultiLevelCodec_h_GUID_3266626A_CC45_465F_879C_512BB94469BD
+#define INCLUDED_MultiLevelCodec_h_GUID_3266626A_CC45_465F_879C_512BB94469BD
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+#include "multi_level.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// The pulses of a frame, usec - the firmware defaults unless set with "FW",
+/// "NW" and "BW".
+struct PulseSchedule {
+  int flashUs = FLASH_BRIGHT_PERIOD;
+  int levelUs = FLASH_LEVEL_PERIOD;
+  int blankUs = FLASH_DIM_PERIOD;
+};
+
+/// An LED's symbols for each row of the pattern table, as characters '0' to '3'.
+using LevelCode = std::string;
+
+class MultiLevelCodec {
+public:
+  explicit MultiLevelCodec(PulseSchedule const &schedule = PulseSchedule()) : schedule_(schedule) {}
+
+  PulseSchedule const &schedule() const { return schedule_; }
+
+  /// Usec an LED at this level is lit per frame.
+  int litUs(int level) const {
+    return multi_level_lit_us(static_cast<uint8_t>(level), static_cast<uint16_t>(schedule_.flashUs),
+                              static_cast<uint16_t>(schedule_.levelUs), static_cast<uint16_t>(schedule_.blankUs));
+  }
+
+  /// Smallest brightness ratio between a level and the one below it - what the
+  /// tracker has to resolve. Below 1 the levels are out of order.
+  double minContrast() const {
+    double ret = 1e9;
+    for (int level = 1; level < MULTI_LEVEL_COUNT; ++level) {
+      ret = std::min(ret, static_cast<double>(litUs(level)) / litUs(level - 1));
+    }
+    return ret;
+  }
+
+  /// Level whose lit time is nearest (by ratio, as the camera sees it) to a
+  /// measured one.
+  int decode(double litUs) const {
+    int best = 0;
+    double bestError = 1e9;
+    for (int level = 0; level < MULTI_LEVEL_COUNT; ++level) {
+      double error = std::fabs(std::log(litUs / this->litUs(level)));
+      if (error < bestError) {
+        best = level;
+        bestError = error;
+      }
+    }
+    return best;
+  }
+
+  /// Fills in both tables from a code per LED (missing LEDs stay at level 0) -
+  /// returns false if a code is the wrong length or has a bad symbol.
+  static bool encode(std::vector<LevelCode> const &codes, uint8_t patterns[PATTERN_COUNT][LED_LINE_LENGTH],
+                     uint8_t levels[PATTERN_COUNT][LED_LINE_LENGTH]) {
+    std::memset(patterns, 0, PATTERN_COUNT * LED_LINE_LENGTH);
+    std::memset(levels, 0, PATTERN_COUNT * LED_LINE_LENGTH);
+    if (codes.size() > LED_LINE_LENGTH * 8) {
+      return false;
+    }
+    for (size_t led = 0; led < codes.size(); ++led) {
+      if (codes[led].size() != PATTERN_COUNT) {
+        return false;
+      }
+      for (int row = 0; row < PATTERN_COUNT; ++row) {
+        int symbol = codes[led][row] - '0';
+        if (symbol < 0 || symbol >= MULTI_LEVEL_COUNT) {
+          return false;
+        }
+        multi_level_set(patterns[row], levels[row], static_cast<uint8_t>(led), static_cast<uint8_t>(symbol));
+      }
+    }
+    return true;
+  }
+
+  /// An LED's code back from the tables.
+  static LevelCode code(uint8_t const patterns[PATTERN_COUNT][LED_LINE_LENGTH],
+                        uint8_t const levels[PATTERN_COUNT][LED_LINE_LENGTH], int led) {
+    LevelCode ret;
+    for (int row = 0; row < PATTERN_COUNT; ++row) {
+      ret += static_cast<char>('0' + multi_level_get(patterns[row], levels[row], static_cast<uint8_t>(led)));
+    }
+    return ret;
+  }
+
+  /// Fewest frames in which every one of a number of LEDs can show a distinct
+  /// code, with this many symbols per frame.
+  static int framesToIdentify(int leds, int symbols) {
+    int frames = 0;
+    for (long codes = 1; codes < leds; codes *= symbols) {
+      ++frames;
+    }
+    return frames;
+  }
+
+private:
+  PulseSchedule schedule_;
+};
+
+#endif // INCLUDED_MultiLevelCodec_h_GUID_3266626A_CC45_465F_879C_512BB94469BD
@@ -0,0 +1,131 @@
+/** @file
+    @brief App that turns per-LED multi-level codes (one symbol of 0-3 per
+   pattern row) into the "PW"/"GW" commands loading them and the "NW" level
+   pulse, and reports how far apart the levels are and how many frames the
+   tracker needs to tell the LEDs apart, against binary codes.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MultiLevelCodec.h"
+#include "PatternSet.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const int NUM_LEDS = LED_COUNT;
+
+/// Without a codes file: the default bank's codes, each row also carrying the
+/// next row's bit in the level plane, so a window of frames holds twice the bits.
+static std::vector<LevelCode> foldedDefaultCodes() {
+  default_array_init();
+  auto patterns = PatternSet::fromPatternArray(active_pattern_rows);
+  std::vector<LevelCode> codes(NUM_LEDS);
+  for (int led = 0; led < NUM_LEDS; ++led) {
+    for (int row = 0; row < PATTERN_COUNT; ++row) {
+      auto bit = [&](int r) { return patterns.bit(led, r % PATTERN_COUNT) ? 1 : 0; };
+      codes[led] += static_cast<char>('0' + (bit(row) << 1 | bit(row + 1)));
+    }
+  }
+  return codes;
+}
+
+static void printRow(char command, int row, uint8_t const *bytes) {
+  std::cout << command << "W:" << std::hex << std::uppercase << row << ":";
+  for (int i = 0; i < LED_LINE_LENGTH; ++i) {
+    std::cout << std::setw(2) << std::setfill('0') << int(bytes[i]) << ",";
+  }
+  std::cout << std::dec << std::setfill(' ') << "\n";
+}
+
+int main(int argc, char *argv[]) {
+  PulseSchedule schedule;
+  std::vector<LevelCode> codes;
+  if (argc > 1 && std::string(argv[1]) != "-") {
+    std::ifstream file(argv[1]);
+    if (!file) {
+      std::cerr << "Could not open " << argv[1] << std::endl;
+      return 1;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      if (!line.empty() && line[0] != '#') {
+        codes.push_back(line);
+      }
+    }
+  } else {
+    codes = foldedDefaultCodes();
+  }
+  if (argc > 2) {
+    schedule.levelUs = std::atoi(argv[2]);
+  }
+
+  uint8_t patterns[PATTERN_COUNT][LED_LINE_LENGTH];
+  uint8_t levels[PATTERN_COUNT][LED_LINE_LENGTH];
+  if (schedule.levelUs < 10 || !MultiLevelCodec::encode(codes, patterns, levels)) {
+    std::cerr << "Usage: " << argv[0] << " [codes file, one line of " << PATTERN_COUNT
+              << " symbols 0-3 per LED, or - for the default bank folded] [level pulse usec]" << std::endl;
+    return 1;
+  }
+
+  MultiLevelCodec codec(schedule);
+  std::cout << "Lit per frame (usec):";
+  for (int level = 0; level < MULTI_LEVEL_COUNT; ++level) {
+    std::cout << " " << level << "=" << codec.litUs(level);
+  }
+  std::cout << ", adjacent levels at least " << std::setprecision(3) << codec.minContrast() << "x apart\n";
+  std::cout << "Frames to identify " << NUM_LEDS << " LEDs: " << MultiLevelCodec::framesToIdentify(NUM_LEDS, 2)
+            << " binary, " << MultiLevelCodec::framesToIdentify(NUM_LEDS, MULTI_LEVEL_COUNT) << " multi-level\n\n";
+
+  for (size_t led = 0; led < codes.size(); ++led) {
+    std::cout << "LED " << std::setw(2) << led << ": " << MultiLevelCodec::code(patterns, levels, int(led)) << "\n";
+  }
+  std::cout << "\n";
+  for (int row = 0; row < PATTERN_COUNT; ++row) {
+    printRow('P', row, patterns[row]);
+  }
+  for (int row = 0; row < PATTERN_COUNT; ++row) {
+    printRow('G', row, levels[row]);
+  }
+  std::cout << "NW:" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << schedule.levelUs << std::dec
+            << "\n";
+
+  if (codec.minContrast() <= 1.) {
+    std::cerr << "Levels out of order - lengthen the level pulse or shorten it below the bright one." << std::endl;
+    return 1;
+  }
+  return 0;
+}
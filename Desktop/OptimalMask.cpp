@@ -0,0 +1,115 @@
+/** @file
+    @brief App that finds the best set of beacons to mask under BrightNeighbors'
+   distance cost - exactly, by branch and bound across all cores - and reports
+   how far BrightNeighbors' greedy choice, one most expensive beacon at a time,
+   is from it.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "CoBrightness.h"
+#include "MaskCost.h"
+#include "MaskSearch.h"
+#include "Patterns.h"
+#include "Positions.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// Beacons to mask besides the ones not fitted, by default: as many as
+/// BrightNeighbors' HDK2 runs add.
+static const int DEFAULT_MASK_COUNT = 4;
+
+using Mask = MaskSearch::Mask;
+
+static void printMask(std::string const &title, Mask const &mask, double cost) {
+  std::cout << title;
+  for (auto led : mask) {
+    std::cout << " " << led + 1;
+  }
+  std::cout << "\t(total cost " << cost << ")\n";
+}
+
+int main(int argc, char *argv[]) {
+  int count = DEFAULT_MASK_COUNT;
+  int threads = 0;
+  bool hdk2 = true;
+  std::vector<std::string> args(argv + 1, argv + argc);
+  auto positional = 0;
+  for (auto const &arg : args) {
+    if (arg == "--hdk1") {
+      hdk2 = false;
+    } else if (positional++ == 0) {
+      count = std::atoi(arg.c_str());
+    } else {
+      threads = std::atoi(arg.c_str());
+    }
+  }
+
+  CoBrightness coBrightness(OsvrHdkLedLocations_SENSOR0, hdkSensor0Patterns());
+  MaskCost base(coBrightness);
+  if (hdk2) {
+    for (auto beacon : OsvrHdk2MissingBeacons_SENSOR0) {
+      base.mask(beacon - 1);
+    }
+  }
+  auto candidates = base.ledCount() - static_cast<int>(base.maskedLeds().size());
+  if (count < 1 || count > candidates || threads < 0 || positional > 2) {
+    std::cerr << "Usage: " << argv[0] << " [beacons to mask, 1-" << candidates << "] [threads] [--hdk1]\n"
+              << "Masks beacons besides the ones not fitted on HDK2, unless --hdk1." << std::endl;
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto greedy = MaskSearch::greedy(base, count);
+  MaskSearch search(base, count, threads);
+  search.run();
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "Masking " << count << " of " << candidates << " beacons";
+  if (hdk2) {
+    std::cout << " (beacons not fitted on HDK2 masked already)";
+  }
+  std::cout << ", " << search.threadCount() << " threads.\n";
+  printMask("Before masking:", Mask{}, base.totalCost());
+  auto greedyCost = MaskSearch::costOf(base, greedy);
+  auto optimalCost = MaskSearch::costOf(base, search.best());
+  printMask("Greedy (BrightNeighbors' order):", greedy, greedyCost);
+  printMask("Optimal:", search.best(), optimalCost);
+  if (greedyCost > optimalCost) {
+    std::cout << "The greedy mask costs " << greedyCost - optimalCost << " more than the optimum ("
+              << 100. * (greedyCost - optimalCost) / optimalCost << "%).\n";
+  } else {
+    std::cout << "The greedy mask is optimal.\n";
+  }
+  std::cout << "Searched " << search.nodes() << " nodes in " << seconds << " s." << std::endl;
+  return 0;
+}
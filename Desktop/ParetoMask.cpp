@@ -0,0 +1,173 @@
+/** @file
+    @brief App that lays out the real tradeoffs in masking beacons: for each
+   number masked, the least interference cost at each guaranteed number of LEDs
+   still lit in every region of the face plate, keeping only the masks no other
+   beats on all three.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "CoBrightness.h"
+#include "MaskCost.h"
+#include "MaskSearch.h"
+#include "Patterns.h"
+#include "Positions.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Most beacons to mask besides the ones not fitted, by default.
+static const int DEFAULT_MAX_MASK_COUNT = 6;
+
+/// Face plate regions, split across x (mm): the two sides and the middle,
+/// each seen from a different range of head turns.
+static const double REGION_HALF_WIDTH = 40.;
+static const char *const REGION_NAMES[] = {"-x side", "center", "+x side"};
+static const int REGION_COUNT = 3;
+
+using Mask = MaskSearch::Mask;
+
+static int regionOf(Point3 const &location) {
+  if (location[0] < -REGION_HALF_WIDTH) {
+    return 0;
+  }
+  return location[0] > REGION_HALF_WIDTH ? 2 : 1;
+}
+
+struct Point {
+  int masked;
+  std::vector<int> lit;
+  double cost;
+  Mask mask;
+  int worstLit() const { return *std::min_element(lit.begin(), lit.end()); }
+  /// At least as good on every count, and better on one.
+  bool dominates(Point const &other) const {
+    return masked <= other.masked && worstLit() >= other.worstLit() && cost <= other.cost &&
+           (masked < other.masked || worstLit() > other.worstLit() || cost < other.cost);
+  }
+};
+
+static std::vector<int> litPerRegion(MaskCost const &base, std::vector<int> const &regions, Mask const &mask) {
+  std::vector<int> ret(REGION_COUNT, 0);
+  for (int led = 0; led < base.ledCount(); ++led) {
+    if (!base.isMasked(led) && std::find(mask.begin(), mask.end(), led) == mask.end()) {
+      ++ret[regions[led]];
+    }
+  }
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  int maxCount = DEFAULT_MAX_MASK_COUNT;
+  int threads = 0;
+  bool hdk2 = true;
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--hdk1") {
+      hdk2 = false;
+    } else if (positional++ == 0) {
+      maxCount = std::atoi(argv[i]);
+    } else {
+      threads = std::atoi(argv[i]);
+    }
+  }
+
+  CoBrightness coBrightness(OsvrHdkLedLocations_SENSOR0, hdkSensor0Patterns());
+  MaskCost base(coBrightness);
+  if (hdk2) {
+    for (auto beacon : OsvrHdk2MissingBeacons_SENSOR0) {
+      base.mask(beacon - 1);
+    }
+  }
+  std::vector<int> regions;
+  for (auto const &location : OsvrHdkLedLocations_SENSOR0) {
+    regions.push_back(regionOf(location));
+  }
+  auto candidates = base.ledCount() - static_cast<int>(base.maskedLeds().size());
+  if (maxCount < 1 || maxCount > candidates || threads < 0 || positional > 2) {
+    std::cerr << "Usage: " << argv[0] << " [most beacons to mask, 1-" << candidates << "] [threads] [--hdk1]\n"
+              << "Masks beacons besides the ones not fitted on HDK2, unless --hdk1." << std::endl;
+    return 1;
+  }
+
+  // The unconstrained optimum for each count, then the least cost with each
+  // more LEDs guaranteed in the worst region, until none can be kept.
+  std::vector<Point> points{Point{0, litPerRegion(base, regions, Mask{}), base.totalCost(), Mask{}}};
+  int searchThreads = 0;
+  for (int count = 1; count <= maxCount; ++count) {
+    for (int minLit = 0;;) {
+      MaskSearch search(base, count, threads);
+      searchThreads = search.threadCount();
+      search.requireCoverage(regions, minLit);
+      if (!search.run()) {
+        break;
+      }
+      auto const &mask = search.best();
+      points.push_back(Point{count, litPerRegion(base, regions, mask), MaskSearch::costOf(base, mask), mask});
+      minLit = points.back().worstLit() + 1;
+    }
+  }
+
+  std::vector<Point> front;
+  for (auto const &point : points) {
+    if (std::none_of(points.begin(), points.end(), [&](Point const &other) { return other.dominates(point); })) {
+      front.push_back(point);
+    }
+  }
+
+  std::cout << "Regions: x < " << -REGION_HALF_WIDTH << " mm, between, x > " << REGION_HALF_WIDTH << " mm";
+  if (hdk2) {
+    std::cout << "; beacons not fitted on HDK2 masked already";
+  }
+  std::cout << "; " << searchThreads << " threads.\n";
+  std::cout << "Pareto front - fewer beacons masked, more lit in the worst region, less cost:\n\n";
+  std::cout << "Masked  Worst  Total cost ";
+  for (auto name : REGION_NAMES) {
+    std::cout << std::setw(8) << name;
+  }
+  std::cout << "  Mask (one-based)\n";
+  for (auto const &point : front) {
+    std::cout << std::setw(6) << point.masked << std::setw(7) << point.worstLit() << std::setw(12) << point.cost
+              << " ";
+    for (auto lit : point.lit) {
+      std::cout << std::setw(8) << lit;
+    }
+    std::ostringstream mask;
+    for (auto led : point.mask) {
+      mask << " " << led + 1;
+    }
+    std::cout << " " << mask.str() << "\n";
+  }
+  std::cout << "\nThe first row at each count is its cheapest mask; the rest trade cost for coverage." << std::endl;
+  return 0;
+}
@@ -0,0 +1,167 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "PatternSet.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <stdexcept>
+
+const int PatternSet::WORD_BITS;
+const char PatternSet::DIM_CHAR;
+const char PatternSet::BRIGHT_CHAR;
+const char PatternSet::DISABLED_CHAR;
+
+PatternSet::PatternSet(int ledCount, int stepCount)
+    : ledCount_(ledCount), stepCount_(stepCount), ledWordCount_(wordsFor(stepCount)),
+      stepWordCount_(wordsFor(ledCount)), ledMajor_(ledCount * ledWordCount_),
+      stepMajor_(stepCount * stepWordCount_) {}
+
+PatternSet PatternSet::fromRows(uint8_t const *rows, int rowBytes, int stepCount, int ledCount) {
+  if (ledCount > rowBytes * 8) {
+    throw std::invalid_argument("Rows are too short for the LED count");
+  }
+  PatternSet ret(ledCount, stepCount);
+  for (int step = 0; step < stepCount; ++step) {
+    auto words = &ret.stepMajor_[step * ret.stepWordCount_];
+    // Bytes go straight into the words, LED n staying at bit n.
+    for (int b = 0; b < (ledCount + 7) / 8; ++b) {
+      words[b / 8] |= Word(rows[step * rowBytes + b]) << (8 * (b % 8));
+    }
+    if (ledCount % WORD_BITS) {
+      words[ret.stepWordCount_ - 1] &= (Word(1) << (ledCount % WORD_BITS)) - 1;
+    }
+    forEachBit(words, ret.stepWordCount_, [&](int led) {
+      ret.ledMajor_[led * ret.ledWordCount_ + step / WORD_BITS] |= Word(1) << (step % WORD_BITS);
+    });
+  }
+  return ret;
+}
+
+PatternSet PatternSet::fromTrackerStrings(std::vector<std::string> const &codes) {
+  auto withoutDisabled = [](std::string const &code) {
+    return !code.empty() && code.front() == DISABLED_CHAR ? code.substr(1) : code;
+  };
+  auto stepCount = codes.empty() ? 0 : static_cast<int>(withoutDisabled(codes.front()).size());
+  PatternSet ret(static_cast<int>(codes.size()), stepCount);
+  for (int led = 0; led < ret.ledCount_; ++led) {
+    auto code = withoutDisabled(codes[led]);
+    if (static_cast<int>(code.size()) != stepCount) {
+      throw std::invalid_argument("Pattern strings were different lengths: " + codes[led]);
+    }
+    for (int step = 0; step < stepCount; ++step) {
+      if (code[step] != DIM_CHAR && code[step] != BRIGHT_CHAR) {
+        throw std::invalid_argument("Bad character in pattern string: " + codes[led]);
+      }
+      ret.set(led, step, code[step] == BRIGHT_CHAR);
+    }
+  }
+  return ret;
+}
+
+void PatternSet::set(int led, int step, bool bright) {
+  auto &ledWord = ledMajor_[led * ledWordCount_ + step / WORD_BITS];
+  auto &stepWord = stepMajor_[step * stepWordCount_ + led / WORD_BITS];
+  auto ledBit = Word(1) << (step % WORD_BITS);
+  auto stepBit = Word(1) << (led % WORD_BITS);
+  if (bright) {
+    ledWord |= ledBit;
+    stepWord |= stepBit;
+  } else {
+    ledWord &= ~ledBit;
+    stepWord &= ~stepBit;
+  }
+}
+
+void PatternSet::clearLed(int led) {
+  auto stepBit = Word(1) << (led % WORD_BITS);
+  for (int step = 0; step < stepCount_; ++step) {
+    stepMajor_[step * stepWordCount_ + led / WORD_BITS] &= ~stepBit;
+  }
+  for (int i = 0; i < ledWordCount_; ++i) {
+    ledMajor_[led * ledWordCount_ + i] = 0;
+  }
+}
+
+int PatternSet::distance(int led, PatternSet const &other, int otherLed) const {
+  if (other.stepCount_ != stepCount_) {
+    throw std::invalid_argument("Pattern sets have different step counts");
+  }
+  auto a = ledWords(led);
+  auto b = other.ledWords(otherLed);
+  int ret = 0;
+  for (int i = 0; i < ledWordCount_; ++i) {
+    ret += popcount(a[i] ^ b[i]);
+  }
+  return ret;
+}
+
+int PatternSet::findLed(PatternSet const &other, int otherLed) const {
+  for (int led = 0; led < ledCount_; ++led) {
+    if (distance(led, other, otherLed) == 0) {
+      return led;
+    }
+  }
+  return -1;
+}
+
+PatternSet PatternSet::selectLeds(std::vector<int> const &leds) const {
+  PatternSet ret(static_cast<int>(leds.size()), stepCount_);
+  for (int i = 0; i < ret.ledCount_; ++i) {
+    auto code = ledWords(leds[i]);
+    forEachBit(code, ledWordCount_, [&](int step) { ret.set(i, step, true); });
+  }
+  return ret;
+}
+
+std::string PatternSet::trackerString(int led) const {
+  std::string ret(stepCount_, DIM_CHAR);
+  forEachBit(ledWords(led), ledWordCount_, [&](int step) { ret[step] = BRIGHT_CHAR; });
+  return ret;
+}
+
+std::vector<std::string> PatternSet::trackerStrings() const {
+  std::vector<std::string> ret;
+  for (int led = 0; led < ledCount_; ++led) {
+    ret.push_back(trackerString(led));
+  }
+  return ret;
+}
+
+void PatternSet::toRows(uint8_t *rows, int rowBytes) const {
+  if (ledCount_ > rowBytes * 8) {
+    throw std::invalid_argument("Rows are too short for the LED count");
+  }
+  for (int step = 0; step < stepCount_; ++step) {
+    auto words = stepWords(step);
+    for (int b = 0; b < rowBytes; ++b) {
+      rows[step * rowBytes + b] = b / 8 < stepWordCount_ ? static_cast<uint8_t>(words[b / 8] >> (8 * (b % 8))) : 0;
+    }
+  }
+}
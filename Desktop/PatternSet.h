@@ -0,0 +1,152 @@
+/** @file
+    @brief Header for PatternSet: a set of LED flash codes held as packed
+   bitsets, both LED-major (one LED's code across the steps) and step-major
+   (one step's bright LEDs), so tools can work a word at a time in either
+   direction.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_PatternSet_h_GUID_3C1E9A47_5B2D_4F86_A0D3_7E94B1C26F58
+#define INCLUDED_PatternSet_h_GUID_3C1E9A47_5B2D_4F86_A0D3_7E94B1C26F58
+
+// Internal Includes
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class PatternSet {
+public:
+  using Word = std::uint64_t;
+  static const int WORD_BITS = 64;
+
+  /// The tracker's pattern string characters.
+  static const char DIM_CHAR = '.';
+  static const char BRIGHT_CHAR = '*';
+  /// A leading 'X' in the tracker's tables marks an LED it doesn't expect to
+  /// see - it isn't part of the code.
+  static const char DISABLED_CHAR = 'X';
+
+  PatternSet() = default;
+  /// All dim.
+  PatternSet(int ledCount, int stepCount);
+
+  /// From firmware-layout rows: one row per step, LED n in bit n % 8 of byte
+  /// n / 8 - pattern_array, a pattern bank, the driver buffer or a mask.
+  static PatternSet fromRows(uint8_t const *rows, int rowBytes, int stepCount, int ledCount);
+  static PatternSet fromPatternArray(uint8_t const (*rows)[LED_LINE_LENGTH]) {
+    return fromRows(rows[0], LED_LINE_LENGTH, PATTERN_COUNT, LED_COUNT);
+  }
+  /// From the tracker's format, one "*..*" string per LED. Throws
+  /// std::invalid_argument on other characters or strings of different lengths.
+  static PatternSet fromTrackerStrings(std::vector<std::string> const &codes);
+
+  int ledCount() const { return ledCount_; }
+  int stepCount() const { return stepCount_; }
+  bool empty() const { return ledCount_ == 0 || stepCount_ == 0; }
+
+  bool bit(int led, int step) const {
+    return 0 != (ledWords(led)[step / WORD_BITS] & (Word(1) << (step % WORD_BITS)));
+  }
+  void set(int led, int step, bool bright);
+  /// Makes the LED dim at every step, as the firmware's mask does.
+  void clearLed(int led);
+
+  /// The LED's code, bit n for step n.
+  Word const *ledWords(int led) const { return &ledMajor_[led * ledWordCount_]; }
+  int ledWordCount() const { return ledWordCount_; }
+  /// The LEDs bright at the step, bit n for LED n.
+  Word const *stepWords(int step) const { return &stepMajor_[step * stepWordCount_]; }
+  int stepWordCount() const { return stepWordCount_; }
+
+  /// The code of an LED in a set of no more than WORD_BITS steps.
+  Word code(int led) const { return ledWords(led)[0]; }
+
+  int brightSteps(int led) const { return countBits(ledWords(led), ledWordCount_); }
+  int brightLeds(int step) const { return countBits(stepWords(step), stepWordCount_); }
+  /// Steps at which the two LEDs differ - the sets must have the same step count.
+  int distance(int led, PatternSet const &other, int otherLed) const;
+  /// The LED in this set with the same code as otherLed in other, or -1.
+  int findLed(PatternSet const &other, int otherLed) const;
+
+  /// A set of the given LEDs, in that order - e.g. a beacon order.
+  PatternSet selectLeds(std::vector<int> const &leds) const;
+
+  std::string trackerString(int led) const;
+  std::vector<std::string> trackerStrings() const;
+  /// Back to firmware-layout rows (see fromRows), rowBytes each.
+  void toRows(uint8_t *rows, int rowBytes) const;
+
+  static int popcount(Word w) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    return static_cast<int>(std::bitset<WORD_BITS>(w).count());
+#endif
+  }
+  static int lowestBit(Word w) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int ret = 0;
+    while (!(w & 0x01)) {
+      w >>= 1;
+      ++ret;
+    }
+    return ret;
+#endif
+  }
+  static int countBits(Word const *words, int wordCount) {
+    int ret = 0;
+    for (int i = 0; i < wordCount; ++i) {
+      ret += popcount(words[i]);
+    }
+    return ret;
+  }
+  /// Calls f(n) for each set bit n, in increasing order.
+  template <typename F> static void forEachBit(Word const *words, int wordCount, F &&f) {
+    for (int i = 0; i < wordCount; ++i) {
+      for (auto w = words[i]; w != 0; w &= w - 1) {
+        f(i * WORD_BITS + lowestBit(w));
+      }
+    }
+  }
+
+private:
+  static int wordsFor(int bits) { return (bits + WORD_BITS - 1) / WORD_BITS; }
+  int ledCount_ = 0;
+  int stepCount_ = 0;
+  int ledWordCount_ = 0;
+  int stepWordCount_ = 0;
+  std::vector<Word> ledMajor_;
+  std::vector<Word> stepMajor_;
+};
+
+#endif // INCLUDED_PatternSet_h_GUID_3C1E9A47_5B2D_4F86_A0D3_7E94B1C26F58
@@ -0,0 +1,130 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "Patterns.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+// - none
+
+/// These are from HDKLedIDentifierFactor.cpp
+
+/// @brief Determines the LED IDs for the OSVR HDK sensor 0 (face plate)
+/// These are from the as-built measurements.
+const std::vector<std::string> OsvrHdkLedIdentifier_SENSOR0_PATTERNS = {
+    "X.**....*........" //  5
+    ,
+    "X....**...*......" //  6
+    ,
+    ".*...**........." //  3
+    ,
+    ".........*....**" //  4
+    ,
+    "..*.....**......" //  1
+    ,
+    "*......**......." //  2
+    ,
+    "....*.*..*......" // 10
+    ,
+    ".*.*.*.........." //  8
+    ,
+    ".........*.**..." //  9
+    ,
+    "X**...........*.." //  7
+    ,
+    "....*.*......*.." // 11
+    ,
+    "X*.......*.*....." // 28
+    ,
+    "X.*........*.*..." // 27
+    ,
+    "X.*.........*.*.." // 25
+    ,
+    "..*..*.*........" // 15
+    ,
+    "....*...*.*....." // 16
+    ,
+    "...*.*........*." // 17
+    ,
+    "...*.....*.*...." // 18
+    ,
+    "....*......*..*." // 19
+    ,
+    "....*..*....*..." // 20
+    ,
+    "X..*...*........*" // 21
+    ,
+    "........*..*..*." // 22
+    ,
+    ".......*...*...*" // 23
+    ,
+    "......*...*..*.." // 24
+    ,
+    ".......*....*..*" // 14
+    ,
+    "..*.....*..*...." // 26
+    ,
+    "*....*....*....." // 13
+    ,
+    "...*....*...*..." // 12
+    ,
+    "..*.....*...*..." // 29
+    ,
+    "...*......*...*." // 30
+    ,
+    "***...*........*" // 31
+    ,
+    "...****..*......" // 32
+    ,
+    "*.*..........***" // 33
+    ,
+    "**...........***" // 34
+};
+
+/// @brief Determines the LED IDs for the OSVR HDK sensor 1 (back plate)
+/// These are from the as-built measurements.
+const std::vector<std::string> OsvrHdkLedIdentifier_SENSOR1_PATTERNS = {
+    "X*...........**.." // 37 31 // never actually turns on in production
+    ,
+    "......**.*......" // 38 32
+    ,
+    ".............***" // 39 33
+    ,
+    "X..........*....." // 40 34 // never actually turns on in production
+    ,
+    "...*.......**..." // 33 27
+    ,
+    "...**.....*....." // 34 28
+};
+
+const std::vector<int> OsvrHdk2MissingBeacons_SENSOR0 = {12, 13, 14, 25, 27, 28};
+
+PatternSet hdkSensor0Patterns() { return PatternSet::fromTrackerStrings(OsvrHdkLedIdentifier_SENSOR0_PATTERNS); }
+
+PatternSet hdkSensor1Patterns() { return PatternSet::fromTrackerStrings(OsvrHdkLedIdentifier_SENSOR1_PATTERNS); }
@@ -28,124 +28,30 @@
 #define INCLUDED_Patterns_h_GUID_7F4808CB_757C_4D82_2F6E_C10D805D686F
 
 // Internal Includes
-// - none
+#include "PatternSet.h"
 
 // Library/third-party includes
 // - none
 
 // Standard includes
-#include <algorithm>
 #include <string>
 #include <vector>
 
-/// These are from HDKLedIDentifierFactor.cpp
+/// These are from HDKLedIDentifierFactor.cpp. A leading 'X' marks an LED that
+/// isn't part of the code - the pattern sets below drop it.
 
 /// @brief Determines the LED IDs for the OSVR HDK sensor 0 (face plate)
 /// These are from the as-built measurements.
-std::vector<std::string> OsvrHdkLedIdentifier_SENSOR0_PATTERNS = {
-    "X.**....*........" //  5
-    ,
-    "X....**...*......" //  6
-    ,
-    ".*...**........." //  3
-    ,
-    ".........*....**" //  4
-    ,
-    "..*.....**......" //  1
-    ,
-    "*......**......." //  2
-    ,
-    "....*.*..*......" // 10
-    ,
-    ".*.*.*.........." //  8
-    ,
-    ".........*.**..." //  9
-    ,
-    "X**...........*.." //  7
-    ,
-    "....*.*......*.." // 11
-    ,
-    "X*.......*.*....." // 28
-    ,
-    "X.*........*.*..." // 27
-    ,
-    "X.*.........*.*.." // 25
-    ,
-    "..*..*.*........" // 15
-    ,
-    "....*...*.*....." // 16
-    ,
-    "...*.*........*." // 17
-    ,
-    "...*.....*.*...." // 18
-    ,
-    "....*......*..*." // 19
-    ,
-    "....*..*....*..." // 20
-    ,
-    "X..*...*........*" // 21
-    ,
-    "........*..*..*." // 22
-    ,
-    ".......*...*...*" // 23
-    ,
-    "......*...*..*.." // 24
-    ,
-    ".......*....*..*" // 14
-    ,
-    "..*.....*..*...." // 26
-    ,
-    "*....*....*....." // 13
-    ,
-    "...*....*...*..." // 12
-    ,
-    "..*.....*...*..." // 29
-    ,
-    "...*......*...*." // 30
-    ,
-    "***...*........*" // 31
-    ,
-    "...****..*......" // 32
-    ,
-    "*.*..........***" // 33
-    ,
-    "**...........***" // 34
-};
+extern const std::vector<std::string> OsvrHdkLedIdentifier_SENSOR0_PATTERNS;
 
 /// @brief Determines the LED IDs for the OSVR HDK sensor 1 (back plate)
 /// These are from the as-built measurements.
-std::vector<std::string> OsvrHdkLedIdentifier_SENSOR1_PATTERNS = {
-    "X*...........**.." // 37 31 // never actually turns on in production
-    ,
-    "......**.*......" // 38 32
-    ,
-    ".............***" // 39 33
-    ,
-    "X..........*....." // 40 34 // never actually turns on in production
-    ,
-    "...*.......**..." // 33 27
-    ,
-    "...**.....*....." // 34 28
-};
-
-static const auto DIM_CHAR = '.';
-static const auto BRIGHT_CHAR = '*';
-
-const auto NUM_LEDS_SENSOR0 = OsvrHdkLedIdentifier_SENSOR0_PATTERNS.size();
+extern const std::vector<std::string> OsvrHdkLedIdentifier_SENSOR1_PATTERNS;
 
-const auto PATTERN_LENGTH = OsvrHdkLedIdentifier_SENSOR0_PATTERNS.back().length(); // the back LED is enabled.
+/// One-based sensor 0 beacons that aren't fitted on HDK2 hardware.
+extern const std::vector<int> OsvrHdk2MissingBeacons_SENSOR0;
 
-void initPatterns() {
-  auto cleanPattern = [](std::string const &inString) {
-    if (inString.front() == 'X') {
-      return inString.substr(1);
-    }
-    return inString;
-  };
-  std::transform(begin(OsvrHdkLedIdentifier_SENSOR0_PATTERNS), end(OsvrHdkLedIdentifier_SENSOR0_PATTERNS),
-                 begin(OsvrHdkLedIdentifier_SENSOR0_PATTERNS), cleanPattern);
-  std::transform(begin(OsvrHdkLedIdentifier_SENSOR1_PATTERNS), end(OsvrHdkLedIdentifier_SENSOR1_PATTERNS),
-                 begin(OsvrHdkLedIdentifier_SENSOR1_PATTERNS), cleanPattern);
-}
+PatternSet hdkSensor0Patterns();
+PatternSet hdkSensor1Patterns();
 
 #endif // INCLUDED_Patterns_h_GUID_7F4808CB_757C_4D82_2F6E_C10D805D686F
@@ -0,0 +1,80 @@
+/** @file
+    @brief App that labels camera frame timestamps with the pattern row shown,
+   from a log of the firmware's console output with phase reports turned on
+   ("YW:1").
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "PhaseReport.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// Typical USB-serial delivery delay, relative to the camera's frame timestamp.
+static const double DEFAULT_LATENCY_US = 2000.;
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <console log> <frame times> [latency usec]\n"
+              << "  console log: one received byte per line, '<host usec> <hex byte>'\n"
+              << "  frame times: one camera frame timestamp (usec, same clock) per line" << std::endl;
+    return 1;
+  }
+  std::ifstream log(argv[1]);
+  std::ifstream frames(argv[2]);
+  if (!log || !frames) {
+    std::cerr << "Could not open input files" << std::endl;
+    return 1;
+  }
+  double latencyUs = argc > 3 ? std::atof(argv[3]) : DEFAULT_LATENCY_US;
+
+  PhaseReportDecoder decoder;
+  double t;
+  unsigned int byte;
+  while (log >> std::dec >> t >> std::hex >> byte) {
+    decoder.feed(static_cast<uint8_t>(byte), t);
+  }
+  std::vector<double> frameTimes;
+  while (frames >> t) {
+    frameTimes.push_back(t);
+  }
+
+  auto merged = mergeWithFrames(frameTimes, decoder.reports(), latencyUs);
+  std::cerr << decoder.reports().size() << " phase reports, " << frameTimes.size() << " frames, period "
+            << merged.framePeriodUs << " usec, agreement " << std::setprecision(3) << merged.agreement * 100. << "%"
+            << std::endl;
+  std::cout << std::fixed << std::setprecision(0);
+  for (std::size_t i = 0; i < frameTimes.size(); ++i) {
+    std::cout << frameTimes[i] << " " << merged.rows[i] << "\n";
+  }
+  return merged.agreement > 0. ? 0 : 1;
+}
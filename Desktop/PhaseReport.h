@@ -0,0 +1,140 @@
+/** @file
+    @brief Header for consuming the firmware's per-sync phase reports (see
+   User/phase_report.h) and labeling camera frames with the pattern row they
+   show, so LED identification can start from the first frame.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_PhaseReport_h_GUID_91DC8653_1643_45E4_897C_FAFA8ABAB050
+#define INCLUDED_PhaseReport_h_GUID_91DC8653_1643_45E4_897C_FAFA8ABAB050
+
+// Internal Includes
+#include "array_init.h"
+#include "phase_report.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+struct PhaseReport {
+  /// When the host received the byte.
+  double hostTimeUs;
+  int row;
+  bool simulated;
+};
+
+/// Splits the bytes received from the firmware's console into phase reports
+/// and ordinary console text.
+class PhaseReportDecoder {
+public:
+  /// Returns true if the byte was a phase report.
+  bool feed(uint8_t byte, double hostTimeUs) {
+    if (!PHASE_REPORT_IS_REPORT(byte)) {
+      text_ += static_cast<char>(byte);
+      return false;
+    }
+    reports_.push_back(
+        PhaseReport{hostTimeUs, byte & PHASE_REPORT_ROW_MASK, (byte & PHASE_REPORT_SIMULATED) != 0});
+    return true;
+  }
+
+  std::vector<PhaseReport> const &reports() const { return reports_; }
+  std::string const &consoleText() const { return text_; }
+
+private:
+  std::vector<PhaseReport> reports_;
+  std::string text_;
+};
+
+struct MergedFrames {
+  /// Pattern row shown in each camera frame, or -1 if it couldn't be worked out.
+  std::vector<int> rows;
+  double framePeriodUs = 0.;
+  /// Share of reports agreeing with the chosen alignment - anything well under
+  /// 1 suggests the latency given is off by a sizable part of a frame.
+  double agreement = 0.;
+};
+
+/// Labels camera frames with pattern rows.
+///
+/// The row advances by one every sync, so rather than pairing each frame with
+/// the nearest report (reports can sit behind console output for a while), every
+/// report votes for the row of the first frame, and the majority wins. Dropped
+/// camera frames are accounted for by the frame timestamps.
+///
+/// latencyUs is the usual time from a frame's timestamp to the arrival of its
+/// report; it has to be known to within half a frame.
+inline MergedFrames mergeWithFrames(std::vector<double> const &frameTimesUs, std::vector<PhaseReport> const &reports,
+                                    double latencyUs) {
+  MergedFrames ret;
+  ret.rows.assign(frameTimesUs.size(), -1);
+  if (frameTimesUs.size() < 2) {
+    return ret;
+  }
+
+  std::vector<double> diffs;
+  for (std::size_t i = 1; i < frameTimesUs.size(); ++i) {
+    if (frameTimesUs[i] > frameTimesUs[i - 1]) {
+      diffs.push_back(frameTimesUs[i] - frameTimesUs[i - 1]);
+    }
+  }
+  if (diffs.empty()) {
+    return ret;
+  }
+  std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
+  ret.framePeriodUs = diffs[diffs.size() / 2];
+
+  auto t0 = frameTimesUs.front();
+  auto syncIndex = [&](double t) { return static_cast<long>(std::floor((t - t0) / ret.framePeriodUs + 0.5)); };
+  auto wrap = [](long v) { return static_cast<int>(((v % PATTERN_COUNT) + PATTERN_COUNT) % PATTERN_COUNT); };
+
+  std::array<int, PATTERN_COUNT> votes = {};
+  int total = 0;
+  for (auto const &report : reports) {
+    if (report.simulated) {
+      continue;
+    }
+    ++votes[wrap(report.row - syncIndex(report.hostTimeUs - latencyUs))];
+    ++total;
+  }
+  if (total == 0) {
+    return ret;
+  }
+  auto best = std::max_element(votes.begin(), votes.end());
+  auto firstRow = static_cast<int>(std::distance(votes.begin(), best));
+  ret.agreement = double(*best) / total;
+
+  for (std::size_t i = 0; i < frameTimesUs.size(); ++i) {
+    ret.rows[i] = wrap(firstRow + syncIndex(frameTimesUs[i]));
+  }
+  return ret;
+}
+
+#endif // INCLUDED_PhaseReport_h_GUID_91DC8653_1643_45E4_897C_FAFA8ABAB050
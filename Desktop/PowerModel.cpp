@@ -0,0 +1,213 @@
+/** @file
+    @brief App that models the firmware main loop, spinning versus sleeping
+   (wfi, ENABLE_WAIT_FOR_INTERRUPT) between interrupts, to estimate the
+   microcontroller current draw and how soon after an interrupt requests an
+   upload the main loop starts it.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/// Rough costs of the firmware's work, in usec at 16MHz - measure with the
+/// trace ("LR") or test points to refine them.
+struct Costs {
+  /// One main loop iteration with nothing to do: event queue, phase report,
+  /// output pump, console checks.
+  double loopUs = 6.;
+  /// Pushing a frame through the driver chain and latching it.
+  double uploadUs = DRIVER_UPLOAD_US;
+  /// Handling one console byte received or sent, command parsing included.
+  double consoleByteUs = 15.;
+  /// From the interrupt that ends a wfi returning, to the main loop popping
+  /// its event.
+  double wakeUs = 1.;
+  /// Any of the flash process, simulation or sync interrupt handlers.
+  double handlerUs = 6.;
+};
+
+/// Supply current of the microcontroller alone (the LEDs dwarf it), in mA:
+/// ballpark typical datasheet figures at 16MHz - pass your board's measured
+/// values on the command line.
+struct Currents {
+  double runMa = 3.2;
+  double waitMa = 1.2;
+};
+
+struct LoopResult {
+  /// Fraction of the time the CPU is running rather than halted.
+  double busy = 0.;
+  double meanLatencyUs = 0.;
+  double maxLatencyUs = 0.;
+};
+
+static const int SIMULATED_FRAMES = 2000;
+
+/// Times within a frame, after the sync, at which the flash process handlers
+/// request an upload: a dim frame after the bright pulse and after each dim
+/// pulse but the last, then the next pattern once the lockout ends.
+static std::vector<double> uploadRequestTimes() {
+  std::vector<double> ret;
+  double t = SYNC_DELAY_TOTAL_US + FLASH_BRIGHT_PERIOD;
+  for (int group = 0; group < LED_LINE_LENGTH; ++group) {
+    ret.push_back(t);
+    t += FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD;
+  }
+  ret.push_back(t + FLASH_SYNC_LOCKOUT_PERIOD);
+  return ret;
+}
+
+/// Runs the main loop over a stream of upload requests and console bytes (at
+/// random times, consoleBytes per frame on average).
+static LoopResult simulateLoop(bool sleep, double fps, double consoleBytes, Costs const &costs, unsigned seed) {
+  std::mt19937 rng(seed);
+  auto periodUs = 1e6 / fps;
+  auto requestTimes = uploadRequestTimes();
+
+  // Syncs don't line up with the loop: jitter them by a few iterations.
+  std::uniform_real_distribution<double> jitter(0., 10. * costs.loopUs);
+  std::vector<double> requests;
+  std::vector<double> bytes;
+  for (int frame = 0; frame < SIMULATED_FRAMES; ++frame) {
+    auto sync = frame * periodUs + jitter(rng);
+    for (auto t : requestTimes) {
+      requests.push_back(sync + t);
+    }
+  }
+  auto endUs = SIMULATED_FRAMES * periodUs;
+  if (consoleBytes > 0.) {
+    std::exponential_distribution<double> gap(consoleBytes / periodUs);
+    for (double t = gap(rng); t < endUs; t += gap(rng)) {
+      bytes.push_back(t);
+    }
+  }
+
+  const double never = std::numeric_limits<double>::max();
+  std::size_t nextRequest = 0, nextByte = 0;
+  double t = 0., runUs = 0., latencySum = 0., maxLatency = 0.;
+  while (t < endUs) {
+    auto start = t;
+    // Top of the loop: one event, if any, then the console.
+    if (nextRequest < requests.size() && requests[nextRequest] <= t) {
+      auto latency = t - requests[nextRequest];
+      latencySum += latency;
+      maxLatency = std::max(maxLatency, latency);
+      ++nextRequest;
+      t += costs.uploadUs;
+    }
+    if (nextByte < bytes.size() && bytes[nextByte] <= t) {
+      ++nextByte;
+      t += costs.consoleByteUs;
+    }
+    t += costs.loopUs;
+    runUs += t - start;
+
+    if (sleep) {
+      auto request = nextRequest < requests.size() ? requests[nextRequest] : never;
+      auto byte = nextByte < bytes.size() ? bytes[nextByte] : never;
+      auto wake = std::min(request, byte);
+      if (wake > t) {
+        // Halted until the interrupt - then the loop starts over at the top.
+        t = std::min(wake, endUs) + costs.wakeUs;
+        runUs += costs.wakeUs;
+      }
+    }
+  }
+
+  LoopResult ret;
+  // The handlers run either way: one per request, plus the sync and bright
+  // pulse start.
+  auto handlerUs = (requestTimes.size() + 2) * SIMULATED_FRAMES * costs.handlerUs;
+  ret.busy = std::min(1., (runUs + handlerUs) / t);
+  ret.meanLatencyUs = nextRequest ? latencySum / nextRequest : 0.;
+  ret.maxLatencyUs = maxLatency;
+  return ret;
+}
+
+static double averageMa(LoopResult const &result, Currents const &currents) {
+  return result.busy * currents.runMa + (1. - result.busy) * currents.waitMa;
+}
+
+int main(int argc, char *argv[]) {
+  Currents currents;
+  Costs costs;
+  if (argc > 1) {
+    currents.runMa = std::atof(argv[1]);
+  }
+  if (argc > 2) {
+    currents.waitMa = std::atof(argv[2]);
+  }
+  if (argc > 3) {
+    costs.loopUs = std::atof(argv[3]);
+  }
+
+  std::cout << "Usage: " << argv[0] << " [run mA] [wait mA] [idle loop usec]\n\n";
+  std::cout << "MCU current: run " << currents.runMa << " mA, wait (wfi) " << currents.waitMa << " mA\n";
+  std::cout << "Costs (usec): loop " << costs.loopUs << ", upload " << costs.uploadUs << ", console byte "
+            << costs.consoleByteUs << ", wake " << costs.wakeUs << ", handler " << costs.handlerUs << "\n";
+  std::cout << LED_LINE_LENGTH + 1 << " uploads per frame\n\n";
+
+  struct Traffic {
+    const char *name;
+    double bytesPerFrame;
+  };
+  /// "QW:" request and "QR:" reply, with the echo, as in StreamBudget.
+  static const double STREAM_BYTES = 2. * (3 + LED_LINE_LENGTH * 3 + 1) + 12;
+  static const Traffic TRAFFIC[] = {{"quiet console", 0.}, {"phase reports", 1.}, {"frame streaming", STREAM_BYTES}};
+  static const double RATES[] = {1000. / SIMULATION_PERIOD, 60., 90., 120.};
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::setw(16) << "console" << std::setw(6) << "Hz" << std::setw(8) << "busy %" << std::setw(10)
+            << "spin mA" << std::setw(10) << "wfi mA" << std::setw(8) << "saved" << std::setw(22)
+            << "spin latency mean/max" << std::setw(21) << "wfi latency mean/max"
+            << "\n";
+  for (auto const &traffic : TRAFFIC) {
+    for (auto fps : RATES) {
+      auto spin = simulateLoop(false, fps, traffic.bytesPerFrame, costs, 1234);
+      auto wfi = simulateLoop(true, fps, traffic.bytesPerFrame, costs, 1234);
+      auto spinMa = averageMa(spin, currents);
+      auto wfiMa = averageMa(wfi, currents);
+      std::cout << std::setw(16) << traffic.name << std::setw(6) << fps << std::setw(8) << 100. * wfi.busy
+                << std::setw(10) << spinMa << std::setw(10) << wfiMa << std::setw(7)
+                << 100. * (spinMa - wfiMa) / spinMa << "%" << std::setw(12) << spin.meanLatencyUs << " /"
+                << std::setw(6) << spin.maxLatencyUs << std::setw(14) << wfi.meanLatencyUs << " /" << std::setw(6)
+                << wfi.maxLatencyUs << "\n";
+    }
+  }
+  std::cout << "\nLatency is from the handler queueing an upload to the main loop starting it, in usec." << std::endl;
+  return 0;
+}
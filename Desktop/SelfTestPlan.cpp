@@ -0,0 +1,82 @@
+/** @file
+    @brief App that lists the factory self-test steps (see User/self_test.h):
+   which LEDs each lights, bright or dim, and which of those a pattern bank's
+   mask keeps dark - the table a test station checks the "MR" step counter
+   against - plus how long the whole walk takes.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "array_init.h"
+#include "self_test.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+static std::string ledList(uint8_t const *leds) {
+  std::string ret;
+  for (int led = 0; led < SELF_TEST_LED_COUNT; ++led) {
+    if (leds[led / 8] & (1 << (led % 8))) {
+      ret += (ret.empty() ? "" : ",") + std::to_string(led);
+    }
+  }
+  return ret.empty() ? "-" : ret;
+}
+
+int main(int argc, char *argv[]) {
+  int framesPerStep = argc > 1 ? std::atoi(argv[1]) : SELF_TEST_FRAMES_PER_STEP;
+  double fps = argc > 2 ? std::atof(argv[2]) : 1000. / SIMULATION_PERIOD;
+  int bank = argc > 3 ? std::atoi(argv[3]) : DEFAULT_PATTERN_BANK;
+  if (framesPerStep < 1 || framesPerStep > 0xFF || fps <= 0. || bank < 0 || bank >= PATTERN_BANK_COUNT) {
+    std::cerr << "Usage: " << argv[0] << " [frames per step (1-255)] [sync Hz] [mask bank]" << std::endl;
+    return 1;
+  }
+  auto const &mask = pattern_banks[bank].mask;
+
+  std::cout << SELF_TEST_STEP_COUNT << " steps of " << framesPerStep << " frames at " << fps
+            << " Hz: " << SELF_TEST_STEP_COUNT * framesPerStep / fps << " seconds (start with MW:" << std::hex
+            << std::uppercase << std::setw(2) << std::setfill('0') << framesPerStep << std::dec << std::setfill(' ')
+            << ")\n\n";
+  std::cout << "step  kind    lit                        dark (masked, bank " << bank << ")\n";
+  for (int step = 0; step < SELF_TEST_STEP_COUNT; ++step) {
+    uint8_t leds[LED_LINE_LENGTH];
+    uint8_t lit[LED_LINE_LENGTH];
+    uint8_t dark[LED_LINE_LENGTH];
+    bool bright = self_test_step_frame(static_cast<uint8_t>(step), leds) != 0;
+    for (int i = 0; i < LED_LINE_LENGTH; ++i) {
+      lit[i] = leds[i] & mask[i];
+      dark[i] = leds[i] & ~mask[i];
+    }
+    std::cout << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << step << std::dec
+              << std::setfill(' ') << "    " << std::left << std::setw(8) << (bright ? "bright" : "dim")
+              << std::setw(27) << ledList(lit) << ledList(dark) << std::right << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,322 @@
+/** @file
+    @brief App that assembles a flash process program for the firmware
+   micro-sequencer (see User/sequencer.h), checks it against the frame timing
+   budget, and prints the "XW" console commands that load it.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+#include "sequencer.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Rough time the main loop takes to push one frame through the driver chain
+/// and latch it. Waits between an upload and the next pulse shorter than this
+/// make the firmware slip the pulse.
+static const int DEFAULT_UPLOAD_US = DRIVER_UPLOAD_US;
+
+struct SourceStep {
+  SeqStep step;
+  int line;
+  /// Label a loop jumps to, resolved after all lines are read.
+  std::string target;
+};
+
+struct Program {
+  std::vector<SourceStep> steps;
+  std::map<std::string, int> labels;
+};
+
+static bool fail(int line, std::string const &msg) {
+  std::cerr << "line " << line << ": " << msg << std::endl;
+  return false;
+}
+
+static bool parseNumber(std::string const &s, long &out) {
+  char *end = nullptr;
+  out = std::strtol(s.c_str(), &end, 0);
+  return !s.empty() && *end == '\0';
+}
+
+/// Grammar, one step per line, '#' starts a comment:
+///   [label:] pulse <usec>
+///   [label:] wait <usec>
+///   [label:] upload row <n> | upload current | upload group <n> | upload loopgroup
+///   [label:] loop <label or step index> <total iterations>
+///   [label:] end
+static bool parseLine(std::string text, int line, Program &prog) {
+  auto hash = text.find('#');
+  if (hash != std::string::npos) {
+    text.erase(hash);
+  }
+  std::istringstream is(text);
+  std::vector<std::string> words;
+  std::string word;
+  while (is >> word) {
+    words.push_back(word);
+  }
+  if (!words.empty() && words[0].back() == ':') {
+    auto label = words[0].substr(0, words[0].size() - 1);
+    if (prog.labels.count(label)) {
+      return fail(line, "duplicate label " + label);
+    }
+    prog.labels[label] = static_cast<int>(prog.steps.size());
+    words.erase(words.begin());
+  }
+  if (words.empty()) {
+    return true;
+  }
+
+  SourceStep src = {{SEQ_OP_END, 0, 0}, line, ""};
+  long value = 0;
+  auto const &op = words[0];
+  if (op == "pulse" || op == "wait") {
+    if (words.size() != 2 || !parseNumber(words[1], value) || value < 0 || value > 0xFFFF) {
+      return fail(line, op + " takes a duration in usec");
+    }
+    src.step.op = op == "pulse" ? SEQ_OP_PULSE : SEQ_OP_WAIT;
+    src.step.duration = static_cast<uint16_t>(value);
+  } else if (op == "upload") {
+    src.step.op = SEQ_OP_UPLOAD;
+    if (words.size() == 2 && words[1] == "current") {
+      src.step.arg = SEQ_FRAME_CURRENT_ROW;
+    } else if (words.size() == 2 && words[1] == "loopgroup") {
+      src.step.arg = SEQ_FRAME_LOOP_GROUP;
+    } else if (words.size() == 3 && words[1] == "row" && parseNumber(words[2], value) && value >= 0 &&
+               value < PATTERN_COUNT) {
+      src.step.arg = static_cast<uint8_t>(value);
+    } else if (words.size() == 3 && words[1] == "group" && parseNumber(words[2], value) && value >= 0 &&
+               value < LED_LINE_LENGTH) {
+      src.step.arg = static_cast<uint8_t>(SEQ_FRAME_GROUP | value);
+    } else {
+      return fail(line, "upload takes 'row <n>', 'current', 'group <n>' or 'loopgroup'");
+    }
+  } else if (op == "loop") {
+    if (words.size() != 3 || !parseNumber(words[2], value) || value < 1 || value > SEQ_MAX_LOOP_COUNT) {
+      return fail(line, "loop takes a target and an iteration count, up to " + std::to_string(SEQ_MAX_LOOP_COUNT));
+    }
+    src.step.op = SEQ_OP_LOOP;
+    src.step.duration = static_cast<uint16_t>(value);
+    src.target = words[1];
+  } else if (op == "end") {
+    if (words.size() != 1) {
+      return fail(line, "end takes no arguments");
+    }
+  } else {
+    return fail(line, "unknown instruction " + op);
+  }
+  prog.steps.push_back(src);
+  return true;
+}
+
+static bool resolveAndValidate(Program &prog) {
+  bool ok = true;
+  if (prog.steps.size() > SEQ_MAX_STEPS) {
+    std::cerr << "program has " << prog.steps.size() << " steps, the firmware holds " << SEQ_MAX_STEPS << std::endl;
+    return false;
+  }
+  if (prog.steps.size() < SEQ_MAX_STEPS && (prog.steps.empty() || prog.steps.back().step.op != SEQ_OP_END)) {
+    SourceStep end = {{SEQ_OP_END, 0, 0}, 0, ""};
+    prog.steps.push_back(end);
+  }
+  for (std::size_t i = 0; i < prog.steps.size(); ++i) {
+    auto &src = prog.steps[i];
+    if (src.step.op == SEQ_OP_LOOP) {
+      long target = 0;
+      auto it = prog.labels.find(src.target);
+      if (it != prog.labels.end()) {
+        target = it->second;
+      } else if (!parseNumber(src.target, target)) {
+        ok = fail(src.line, "unknown label " + src.target);
+        continue;
+      }
+      src.step.arg = static_cast<uint8_t>(target);
+      // The firmware keeps a single loop counter.
+      for (auto j = target; j >= 0 && j < static_cast<long>(i); ++j) {
+        if (prog.steps[j].step.op == SEQ_OP_LOOP) {
+          ok = fail(src.line, "loops can't nest");
+        }
+        if (prog.steps[j].step.arg == SEQ_FRAME_LOOP_GROUP && prog.steps[j].step.op == SEQ_OP_UPLOAD &&
+            src.step.duration > LED_LINE_LENGTH) {
+          ok = fail(src.line, "loop uploading 'loopgroup' runs past the last driver byte group");
+        }
+      }
+    }
+  }
+
+  // Loops are checked against the whole program, as loaded into the firmware.
+  SeqStep program[SEQ_MAX_STEPS] = {};
+  for (std::size_t i = 0; i < prog.steps.size(); ++i) {
+    program[i] = prog.steps[i].step;
+  }
+  for (std::size_t i = 0; i < prog.steps.size(); ++i) {
+    if (!sequencer_step_is_valid(static_cast<uint8_t>(i), &program[i], program)) {
+      ok = fail(prog.steps[i].line, "step out of the firmware's limits (timed steps: " +
+                                        std::to_string(SEQUENCER_STEP_ADJUSTMENT + 1) + " to " +
+                                        std::to_string(MAX_FLASH_PERIOD - 1) +
+                                        " usec, loops: backwards, unnested, up to " +
+                                        std::to_string(SEQ_MAX_LOOP_COUNT) + " times)");
+    }
+  }
+  return ok;
+}
+
+struct RunStats {
+  long durationUs = 0;
+  long litUs = 0;
+  int interrupts = 0;
+  int uploads = 0;
+  int pulses = 0;
+  /// Pulses the firmware would have to delay because the upload couldn't finish.
+  int uploadSlips = 0;
+};
+
+/// Steps through the program exactly like sequencer_run() in main.c does.
+static RunStats run(Program const &prog, int uploadUs) {
+  RunStats stats;
+  // The first pass happens inside the startup delay's timer interrupt.
+  stats.interrupts = 1;
+  std::size_t pc = 0;
+  unsigned loop = 0;
+  long sinceUpload = -1;
+  while (pc < prog.steps.size()) {
+    auto const &step = prog.steps[pc++].step;
+    if (step.op == SEQ_OP_PULSE || step.op == SEQ_OP_WAIT) {
+      if (step.op == SEQ_OP_PULSE) {
+        if (sinceUpload >= 0 && sinceUpload < uploadUs) {
+          ++stats.uploadSlips;
+        }
+        sinceUpload = -1;
+        stats.litUs += step.duration;
+        ++stats.pulses;
+      } else if (sinceUpload >= 0) {
+        sinceUpload += step.duration;
+      }
+      stats.durationUs += step.duration;
+      ++stats.interrupts;
+    } else if (step.op == SEQ_OP_UPLOAD) {
+      sinceUpload = 0;
+      ++stats.uploads;
+    } else if (step.op == SEQ_OP_LOOP) {
+      if (++loop < step.duration) {
+        pc = step.arg;
+      } else {
+        loop = 0;
+      }
+    } else {
+      break;
+    }
+  }
+  return stats;
+}
+
+/// The firmware checks each loop written against the program it already holds,
+/// so every other step goes first - ending the old program after this one and
+/// clearing its loops - and then the loops, last first, so none of the old
+/// program's is left around one.
+static void printCommands(Program const &prog) {
+  std::cout << std::hex << std::uppercase << std::setfill('0');
+  for (auto loops : {false, true}) {
+    for (std::size_t n = 0; n < SEQ_MAX_STEPS; ++n) {
+      auto i = loops ? SEQ_MAX_STEPS - 1 - n : n;
+      SeqStep step = {SEQ_OP_END, 0, 0};
+      if (i < prog.steps.size()) {
+        step = prog.steps[i].step;
+      }
+      if ((step.op == SEQ_OP_LOOP) != loops) {
+        continue;
+      }
+      std::cout << "XW:" << i << ":" << std::setw(2) << int(step.op) << "," << std::setw(2) << int(step.arg) << ","
+                << std::setw(4) << step.duration << "\n";
+    }
+  }
+  std::cout << std::dec << std::setfill(' ');
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <program.seq> [camera frame rate Hz] [upload usec]" << std::endl;
+    return 1;
+  }
+  std::ifstream file(argv[1]);
+  if (!file) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  double fps = argc > 2 ? std::atof(argv[2]) : 0.;
+  int uploadUs = argc > 3 ? std::atoi(argv[3]) : DEFAULT_UPLOAD_US;
+
+  Program prog;
+  bool ok = true;
+  std::string text;
+  for (int line = 1; std::getline(file, text); ++line) {
+    ok = parseLine(text, line, prog) && ok;
+  }
+  if (!ok || !resolveAndValidate(prog)) {
+    return 1;
+  }
+
+  auto stats = run(prog, uploadUs);
+#ifdef SYNC_DELAY_TOTAL_US
+  long totalUs = SYNC_DELAY_TOTAL_US + stats.durationUs;
+#else
+  long totalUs = stats.durationUs;
+#endif
+  long budgetUs = MAX_TOTAL_DURATION;
+  if (fps > 0. && 1e6 / fps < budgetUs) {
+    budgetUs = static_cast<long>(1e6 / fps);
+  }
+
+  std::cerr << prog.steps.size() << " steps: " << stats.pulses << " pulses (" << stats.litUs << " usec lit), "
+            << stats.uploads << " uploads, " << stats.interrupts << " process timer interrupts per frame\n";
+  std::cerr << "Sync to end of program: " << totalUs << " usec of a " << budgetUs << " usec budget\n";
+
+  if (stats.uploadSlips > 0) {
+    std::cerr << stats.uploadSlips << " pulse(s) follow their upload by less than " << uploadUs
+              << " usec - the firmware will delay them." << std::endl;
+    ok = false;
+  }
+  if (totalUs > budgetUs) {
+    std::cerr << "Program doesn't fit in the frame!" << std::endl;
+    ok = false;
+  }
+  if (!ok) {
+    return 1;
+  }
+  printCommands(prog);
+  return 0;
+}
@@ -0,0 +1,192 @@
+/** @file
+    @brief App that models streaming per-frame LED words to the firmware over
+   the serial console ("QW" command), reporting the link utilization and the
+   stream FIFO depth needed to sustain a given camera frame rate without the
+   firmware falling back to its stored pattern table.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/// "QW:" + "hh," per byte + "\r"
+static const int REQUEST_BYTES = 3 + LED_LINE_LENGTH * 3 + 1;
+/// The firmware echoes every received byte, then replies "QR:cc,uuuu\r\n"
+static const int RESPONSE_BYTES = REQUEST_BYTES + 12;
+/// 8N1 framing
+static const int BITS_PER_BYTE = 10;
+
+/// Time after the sync at which the next frame gets uploaded: the full flash
+/// process, including lockout, has to complete first.
+static const double UPLOAD_OFFSET_US = TOTAL_DURATION;
+
+static const int MAX_DEPTH = 16;
+static const int SIMULATED_FRAMES = 200000;
+
+/// Host-side send latency model: a fixed base (e.g. USB-serial latency timer),
+/// an exponential tail, and occasional long stalls (scheduler, GC, etc.)
+struct HostLatencyModel {
+  double baseUs = 1000.;
+  double meanTailUs = 500.;
+  double stallProbability = 0.001;
+  double stallUs = 8000.;
+};
+
+struct StreamResult {
+  int underruns = 0;
+  int rejected = 0;
+};
+
+inline double byteTimeUs(int baud) { return 1e6 * BITS_PER_BYTE / baud; }
+
+/// Host sends frame k one frame period before it is needed, keeping depth
+/// frames in flight; the firmware pops one frame per sync at the upload offset.
+StreamResult simulateStream(double fps, int baud, int depth, HostLatencyModel const &host, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::exponential_distribution<double> tail(1. / host.meanTailUs);
+  std::uniform_real_distribution<double> coin(0., 1.);
+
+  auto periodUs = 1e6 / fps;
+  auto requestUs = REQUEST_BYTES * byteTimeUs(baud);
+
+  StreamResult ret;
+  std::deque<double> inFlight; // arrival times, in order
+  double linkFreeAt = 0.;
+  int nextToSend = 0;
+  for (int frame = 0; frame < SIMULATED_FRAMES; ++frame) {
+    auto uploadAt = frame * periodUs + UPLOAD_OFFSET_US;
+    // Host tops up the stream: frame k is issued at (k - depth + 1) periods.
+    while (nextToSend < SIMULATED_FRAMES && (nextToSend - depth + 1) * periodUs <= uploadAt) {
+      auto issued = std::max(0., (nextToSend - depth + 1) * periodUs);
+      auto latency = host.baseUs + tail(rng);
+      if (coin(rng) < host.stallProbability) {
+        latency += host.stallUs;
+      }
+      auto start = std::max(issued + latency, linkFreeAt);
+      linkFreeAt = start + requestUs;
+      inFlight.push_back(linkFreeAt);
+      ++nextToSend;
+    }
+    // Frames that arrived to a full FIFO get an "E:full" and are lost.
+    int queued = 0;
+    for (auto it = inFlight.begin(); it != inFlight.end();) {
+      if (*it <= uploadAt && queued >= depth) {
+        ++ret.rejected;
+        it = inFlight.erase(it);
+        continue;
+      }
+      if (*it <= uploadAt) {
+        ++queued;
+      }
+      ++it;
+    }
+    if (!inFlight.empty() && inFlight.front() <= uploadAt) {
+      inFlight.pop_front();
+    } else {
+      ++ret.underruns;
+    }
+  }
+  return ret;
+}
+
+int minimumCleanDepth(double fps, int baud, HostLatencyModel const &host) {
+  for (int depth = 1; depth <= MAX_DEPTH; ++depth) {
+    auto result = simulateStream(fps, baud, depth, host, 1234);
+    if (result.underruns == 0 && result.rejected == 0) {
+      return depth;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char *argv[]) {
+  HostLatencyModel host;
+  if (argc > 1) {
+    host.meanTailUs = std::atof(argv[1]) * 1000.;
+  }
+  if (argc > 2) {
+    host.stallProbability = std::atof(argv[2]);
+  }
+  if (argc > 3) {
+    host.stallUs = std::atof(argv[3]) * 1000.;
+  }
+
+  std::cout << "Usage: " << argv[0] << " [mean host jitter ms] [stall probability] [stall ms]\n\n";
+  std::cout << "Request: " << REQUEST_BYTES << " bytes, echo + response: " << RESPONSE_BYTES << " bytes per frame\n";
+  std::cout << "Upload happens " << UPLOAD_OFFSET_US << " usec after each sync\n";
+  std::cout << "Host latency: base " << host.baseUs << " usec, mean tail " << host.meanTailUs << " usec, stall "
+            << host.stallUs << " usec with p=" << host.stallProbability << "\n\n";
+
+  static const int BAUDS[] = {19200, 38400, 57600, 115200, 230400};
+  static const double RATES[] = {90., 100., 110., 120.};
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::setw(8) << "baud" << std::setw(6) << "Hz" << std::setw(8) << "rx %" << std::setw(8) << "tx %"
+            << std::setw(12) << "byte usec" << std::setw(12) << "min depth" << "\n";
+  for (auto baud : BAUDS) {
+    for (auto fps : RATES) {
+      auto percentPerByte = fps * byteTimeUs(baud) / 1e4;
+      auto rxPercent = REQUEST_BYTES * percentPerByte;
+      auto txPercent = RESPONSE_BYTES * percentPerByte;
+      std::cout << std::setw(8) << baud << std::setw(6) << fps << std::setw(8) << rxPercent << std::setw(8) << txPercent
+                << std::setw(12) << byteTimeUs(baud);
+      if (txPercent >= 100.) {
+        std::cout << std::setw(12) << "link full";
+      } else {
+        auto depth = minimumCleanDepth(fps, baud, host);
+        if (depth < 0) {
+          std::cout << std::setw(12) << ">16";
+        } else {
+          std::cout << std::setw(12) << depth;
+        }
+      }
+      std::cout << "\n";
+    }
+  }
+
+  std::cout << "\nConfigured firmware: " << UART_BAUD_RATE << " baud, FRAME_STREAM_DEPTH " << FRAME_STREAM_DEPTH
+            << "\n";
+  for (auto fps : RATES) {
+    auto result = simulateStream(fps, UART_BAUD_RATE, FRAME_STREAM_DEPTH, host, 1234);
+    std::cout << "  " << fps << " Hz: " << result.underruns << " underruns, " << result.rejected << " rejected of "
+              << SIMULATED_FRAMES << " frames\n";
+  }
+  std::cout << "\nNote: the receive interrupt buffers 8 bytes for the main loop, which must keep up on average "
+               "with the byte time shown above to avoid receive overruns."
+            << std::endl;
+  return 0;
+}
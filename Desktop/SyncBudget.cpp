@@ -0,0 +1,113 @@
+/** @file
+    @brief App that checks the sync divider and multiplier ("VW") against camera
+   frame rates with the firmware's own budget (sync_rate.c), listing which
+   settings fit each rate, and the "VW" command to send for it.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "MCUConfig.h"
+#include "array_init.h"
+#include "sync_rate.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// Camera rates we deploy, when none are given.
+static const double DEFAULT_RATES[] = {30., 60., 90., 100., 120., 180., 240.};
+
+int main(int argc, char *argv[]) {
+  // A process at the default periods, as the firmware measures it after "FW"/"BW"/"IW".
+  long processUs = FLASH_BRIGHT_PERIOD + LED_LINE_LENGTH * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD);
+  std::vector<double> rates;
+  if (argc > 1) {
+    processUs = std::atol(argv[1]);
+  }
+  for (int i = 2; i < argc; ++i) {
+    rates.push_back(std::atof(argv[i]));
+  }
+  if (rates.empty()) {
+    rates.assign(std::begin(DEFAULT_RATES), std::end(DEFAULT_RATES));
+  }
+  if (processUs <= 0 || processUs > 0xFFFF) {
+    std::cerr << "Usage: " << argv[0] << " [process usec] [camera Hz...]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Process " << processUs << " usec";
+#ifdef SYNC_DELAY_TOTAL_US
+  std::cout << " after a " << SYNC_DELAY_TOTAL_US << " usec sync delay";
+#endif
+  std::cout << ", " << FLASH_SYNC_LOCKOUT_PERIOD << " usec lockout\n\n";
+  std::cout << "   Hz  period  fits (divider,multiplier)             VW\n";
+
+  int unmet = 0;
+  for (auto fps : rates) {
+    long periodUs = fps > 0. ? static_cast<long>(1e6 / fps) : 0;
+    if (periodUs <= 0 || periodUs > SYNC_PERIOD_MAX_TICKS * SYNC_PERIOD_TICK_US) {
+      std::cout << std::setw(5) << fps << "  not measured by the firmware\n";
+      ++unmet;
+      continue;
+    }
+    auto period = static_cast<uint16_t>(periodUs);
+    auto process = static_cast<uint16_t>(processUs);
+    std::cout << std::setw(5) << fps << std::setw(8) << periodUs << "  ";
+
+    // Every combination that fits, then the one to use: flash on as many syncs
+    // as possible, a single process each.
+    int width = 0;
+    int bestDivider = 0;
+    for (int divider = 1; divider <= SYNC_DIVIDER_MAX; ++divider) {
+      for (int multiplier = 1; multiplier <= SYNC_MULTIPLIER_MAX; ++multiplier) {
+        if (!sync_rate_fits(period, static_cast<uint8_t>(divider), static_cast<uint8_t>(multiplier), process)) {
+          continue;
+        }
+        if (!bestDivider) {
+          bestDivider = divider;
+        }
+        if (divider == bestDivider || multiplier > 1) {
+          std::cout << divider << "," << multiplier << " ";
+          width += 4;
+        }
+      }
+      if (bestDivider && divider >= bestDivider + 1) {
+        break;
+      }
+    }
+    if (!bestDivider) {
+      std::cout << "none\n";
+      ++unmet;
+      continue;
+    }
+    std::cout << std::setw(38 - width) << "" << "VW:" << std::hex << std::uppercase << bestDivider << ",1" << std::dec
+              << "\n";
+  }
+  return unmet == 0 ? 0 : 1;
+}
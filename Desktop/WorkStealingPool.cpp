@@ -0,0 +1,125 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+// Internal Includes
+#include "WorkStealingPool.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <thread>
+
+/// -1 outside the pool's threads.
+static thread_local int runningThread = -1;
+
+WorkStealingPool::WorkStealingPool(int threads) {
+  if (threads <= 0) {
+    threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  for (int i = 0; i < threads; ++i) {
+    queues_.emplace_back(new Queue);
+  }
+}
+
+int WorkStealingPool::currentThread() { return runningThread; }
+
+void WorkStealingPool::push(Task task) {
+  auto thread = runningThread;
+  if (thread < 0) {
+    thread = nextQueue_;
+    nextQueue_ = (nextQueue_ + 1) % threadCount();
+  }
+  ++pending_;
+  auto &queue = *queues_[thread];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  queue.tasks.push_back(std::move(task));
+}
+
+bool WorkStealingPool::takeTask(int thread, Task &task) {
+  // Own queue from the back, the newest and smallest piece of work...
+  {
+    auto &queue = *queues_[thread];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  // ...others' from the front, the oldest and likely largest.
+  for (int i = 1; i < threadCount(); ++i) {
+    auto &queue = *queues_[(thread + i) % threadCount()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::work(int thread) {
+  runningThread = thread;
+  Task task;
+  while (pending_ != 0) {
+    if (!takeTask(thread, task)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (!failed_) {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        if (!failed_) {
+          error_ = std::current_exception();
+          failed_ = true;
+        }
+      }
+    }
+    task = nullptr;
+    --pending_;
+  }
+  runningThread = -1;
+}
+
+void WorkStealingPool::run() {
+  std::vector<std::thread> threads;
+  for (int i = 1; i < threadCount(); ++i) {
+    threads.emplace_back(&WorkStealingPool::work, this, i);
+  }
+  work(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (failed_) {
+    failed_ = false;
+    std::rethrow_exception(error_);
+  }
+}
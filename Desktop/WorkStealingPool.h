@@ -0,0 +1,85 @@
+/** @file
+    @brief Header for WorkStealingPool: runs a tree of tasks across the cores,
+   each thread keeping its own queue and taking work from the others when it
+   runs dry.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache 2.0
+
+#ifndef INCLUDED_WorkStealingPool_h_GUID_2D8F6B13_A4C9_4E70_8B35_F0E19C7A46D2
+#define INCLUDED_WorkStealingPool_h_GUID_2D8F6B13_A4C9_4E70_8B35_F0E19C7A46D2
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class WorkStealingPool {
+public:
+  using Task = std::function<void()>;
+
+  /// With no thread count, one per hardware thread.
+  explicit WorkStealingPool(int threads = 0);
+
+  int threadCount() const { return static_cast<int>(queues_.size()); }
+
+  /// From a running task, onto the back of its thread's queue, to be run next
+  /// there (depth first) unless another thread steals it first. From outside,
+  /// spread across the queues.
+  void push(Task task);
+
+  /// Runs until every task, including the ones they push, has finished. The
+  /// first exception a task throws is rethrown here, once the threads stop.
+  void run();
+
+  /// The pool thread running the caller, from 0 - to index per-thread state.
+  static int currentThread();
+
+private:
+  bool takeTask(int thread, Task &task);
+  void work(int thread);
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+  std::vector<std::unique_ptr<Queue>> queues_;
+  /// Pushed but not finished - a task's children are pushed before it ends.
+  std::atomic<int> pending_{0};
+  std::atomic<bool> failed_{false};
+  std::exception_ptr error_;
+  std::mutex errorMutex_;
+  int nextQueue_ = 0;
+};
+
+#endif // INCLUDED_WorkStealingPool_h_GUID_2D8F6B13_A4C9_4E70_8B35_F0E19C7A46D2
@@ -32,6 +32,7 @@
 #define INCLUDED_MCUConfig_h_GUID_D1C232A1_AC37_47A3_347A_DFA3E6FE70CA
 
 #include "Config.h"
+#include "array_init.h"
 
 /// running patterns even when no sync arrives.
 #define ENABLE_SIMULATION
@@ -41,6 +42,58 @@
 #define ENABLE_UART
 #endif
 
+#ifdef ENABLE_UART
+/// Serial console baud rate.
+#define UART_BAUD_RATE 115200
+
+/// Accept per-frame LED words streamed over the serial console ahead of each sync,
+/// falling back to the stored pattern table when none are queued.
+#define ENABLE_FRAME_STREAM
+
+/// Number of streamed frames that may be queued - must be a power of two.
+/// Desktop/StreamBudget reports the depth a given baud rate and camera rate needs.
+#define FRAME_STREAM_DEPTH 4
+
+/// Report the pattern row shown after each sync as a single console byte (see
+/// phase_report.h), once turned on with "YW:1".
+#define ENABLE_PHASE_REPORT
+
+/// Count syncs, missed deadlines, dropped output etc. (see perf_counters.h) for
+/// the "TR" command.
+#define ENABLE_PERF_COUNTERS
+
+/// Keep a ring of timestamped events (see trace.h) to drain with "LR" - records
+/// nothing until an event mask is set with "LW".
+#define ENABLE_TRACE
+
+/// Time the boot, to the first flash, on the otherwise unused TIM4 for the "UR"
+/// command.
+#define ENABLE_BOOT_TIME
+#endif
+
+/// Halt the CPU (wfi) in the main loop whenever no interrupt has left it work,
+/// rather than spinning - Desktop/PowerModel estimates the current saved.
+#define ENABLE_WAIT_FOR_INTERRUPT
+
+/// Send the driver frames precomputed into flash (driver_frames.c, generated by
+/// Desktop/GenerateFrames) instead of expanding the pattern bank into RAM at boot
+/// - the RAM tables only take over once something is written. Firmware only: the
+/// desktop tools expand, to generate and check that file.
+#ifdef OSVR_IR_EMBEDDED
+#define ENABLE_FLASH_FRAMES
+#endif
+
+/// Factory self-test (see self_test.h), started with "MW" or the strap pin set
+/// below - Desktop/SelfTestPlan lists what each step lights.
+#define ENABLE_SELF_TEST
+
+/// Frames each self-test step is held for when started by the strap.
+#define SELF_TEST_FRAMES_PER_STEP 2
+
+/// Also signal the pattern row after each sync as a burst of row + 1 pulses on
+/// a spare pin (set below), for hosts that watch a pin instead of the console.
+//#define ENABLE_PHASE_PULSE_CODE
+
 /// Time (usec) it takes from the sync signal going low, to us driving nOE low
 /// (with delay off) - measured with logic analyzer
 #if defined(OSVR_IR_IAR_STM8)
@@ -103,12 +156,9 @@
 #endif
 #endif // !SYNC_DELAY_TOTAL_US
 
-/// For testing, only run the process every SYNC_INTERVAL sync pulses.
-//#define SYNC_INTERVAL 3
-
-#ifdef SYNC_INTERVAL
-/// Can't have SYNC_INTERVAL and the SIMULATION enabled at once.
-#undef ENABLE_SIMULATION
+#ifndef ENABLE_SIMULATION
+/// The trace is timestamped with the simulation timer.
+#undef ENABLE_TRACE
 #endif
 
 /// Periods in microseconds.
@@ -128,6 +178,10 @@
 #define FLASH_DIM_PERIOD 30
 #endif
 
+/// Level pulse of multi-level brightness: half the bright pulse spaces the four levels evenly - dim, then dim plus
+/// half, one and one and a half bright pulses.
+#define FLASH_LEVEL_PERIOD (FLASH_BRIGHT_PERIOD / 2)
+
 /// How long to wait after the end of the LED process before accepting a new sync interrupt?
 #define FLASH_SYNC_LOCKOUT_PERIOD 1000
 
@@ -166,6 +220,53 @@
 
 #endif
 
+/// Run the flash process from a per-frame step program (see sequencer.h) instead of the fixed
+/// bright-then-dim state machine. Experimental: costs 96 bytes of RAM.
+//#define ENABLE_SEQUENCER
+
+/// Usec the sequencer takes to a timed step's nOE edge beyond the fixed state machine, then for each upload
+/// and loop step run ahead of the edge - estimated from the instruction timings (see sequencer_run() in main.c)
+/// until measured on testpoint 10.
+#define SEQUENCER_STEP_OVERHEAD 1
+#define SEQUENCER_UPLOAD_OVERHEAD 4
+#define SEQUENCER_LOOP_OVERHEAD 2
+
+/// Offset taken from every timed sequencer step, the counterpart of the adjustments above: the interval
+/// adjustment plus the interpreter's own overhead. Each step also has the overhead of the upload and loop
+/// steps after it taken off (see sequencer_prepare()).
+#ifndef SEQUENCER_STEP_ADJUSTMENT
+#ifdef MAX_INTERVAL_PERIOD_ADJUSTMENT
+#define SEQUENCER_STEP_ADJUSTMENT (MAX_INTERVAL_PERIOD_ADJUSTMENT + SEQUENCER_STEP_OVERHEAD)
+#else
+#define SEQUENCER_STEP_ADJUSTMENT SEQUENCER_STEP_OVERHEAD
+#endif
+#endif
+
+/// Correct the adjustments above at boot: dry runs of the flash process (with LED power off) are timed
+/// against a free-running timer, so they hold across compilers and code changes. Read them with "CR".
+/// Not with the sequencer, which has its own step adjustment.
+#define ENABLE_CALIBRATION
+
+#ifdef ENABLE_SEQUENCER
+#undef ENABLE_CALIBRATION
+#endif
+
+/// Four brightness levels per LED per frame (see multi_level.h): after the pattern pulse, a level pulse lights the
+/// LEDs of a second bit plane, set with "GW". Experimental: costs 80 bytes of RAM. Fixed state machine only.
+//#define ENABLE_MULTI_LEVEL
+
+#ifdef ENABLE_SEQUENCER
+#undef ENABLE_MULTI_LEVEL
+#endif
+
+/// Allow more than one flash process per camera sync ("VW", see sync_rate.h), spaced evenly over the sync
+/// period - measured with the simulation timer, so not without it. Fixed state machine only.
+#define ENABLE_SYNC_MULTIPLIER
+
+#if !defined(ENABLE_SIMULATION) || defined(ENABLE_SEQUENCER)
+#undef ENABLE_SYNC_MULTIPLIER
+#endif
+
 /// Check individual parameter bounds
 #if FLASH_BRIGHT_PERIOD <= MAX_FLASH_PERIOD_ADJUSTMENT || FLASH_BRIGHT_PERIOD >= MAX_FLASH_PERIOD
 #error "FLASH_BRIGHT_PERIOD out of range!"
@@ -176,6 +277,9 @@
 #if FLASH_DIM_PERIOD <= MAX_BLANK_PERIOD_ADJUSTMENT || FLASH_DIM_PERIOD >= MAX_FLASH_PERIOD
 #error "FLASH_DIM_PERIOD out of range!"
 #endif
+#if FLASH_LEVEL_PERIOD <= MAX_FLASH_PERIOD_ADJUSTMENT || FLASH_LEVEL_PERIOD >= MAX_FLASH_PERIOD
+#error "FLASH_LEVEL_PERIOD out of range!"
+#endif
 
 #if defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
 #if SYNC_DELAY_TOTAL_US > MAX_FLASH_PERIOD
@@ -184,19 +288,36 @@
 #endif
 
 /// Check overall timing
+#ifdef ENABLE_MULTI_LEVEL
+#define LEVEL_PULSE_DURATION (FLASH_INTERVAL_PERIOD + FLASH_LEVEL_PERIOD)
+#else
+#define LEVEL_PULSE_DURATION 0
+#endif
+
 #ifdef SYNC_DELAY_TOTAL_US
 #define TOTAL_DURATION                                                                                                 \
-  (SYNC_DELAY_TOTAL_US + FLASH_BRIGHT_PERIOD + 5 * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD) +                        \
-   FLASH_SYNC_LOCKOUT_PERIOD)
+  (SYNC_DELAY_TOTAL_US + FLASH_BRIGHT_PERIOD + LEVEL_PULSE_DURATION +                                                  \
+   LED_LINE_LENGTH * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD) + FLASH_SYNC_LOCKOUT_PERIOD)
 #else
 #define TOTAL_DURATION                                                                                                 \
-  (FLASH_BRIGHT_PERIOD + 5 * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD) + FLASH_SYNC_LOCKOUT_PERIOD)
+  (FLASH_BRIGHT_PERIOD + LEVEL_PULSE_DURATION + LED_LINE_LENGTH * (FLASH_INTERVAL_PERIOD + FLASH_DIM_PERIOD) +         \
+   FLASH_SYNC_LOCKOUT_PERIOD)
 #endif
 
 #if (TOTAL_DURATION) > MAX_TOTAL_DURATION
 #error "The total timer duration exceeds the available time!"
 #endif
 
+/// Rough time (usec) the main loop takes to shift a frame of BYTES bytes through the driver chain and latch it: 8MHz
+/// SPI polled a byte at a time, about 3 usec a byte with the loop. Measure with the trace ("LR") to refine it.
+#define DRIVER_UPLOAD_US_FOR_BYTES(BYTES) (4 + 3 * (BYTES))
+#define DRIVER_UPLOAD_US DRIVER_UPLOAD_US_FOR_BYTES(DRIVER_CHAIN_BITS / 8)
+
+/// Each dim frame is uploaded between the pulses - Desktop/ChainBudget shows what longer chains cost.
+#if DRIVER_UPLOAD_US > FLASH_INTERVAL_PERIOD
+#error "The driver chain takes longer to upload than FLASH_INTERVAL_PERIOD!"
+#endif
+
 /// Ports and pins
 
 // PB0: IR_LED_PWR_EN active high
@@ -236,4 +357,16 @@
 #define PORT_TESTPOINT_10 GPIOD
 #define PIN_TESTPOINT_10 GPIO_PIN_4
 
+/// Phase pulse code output - pick a pin that's free on your board revision.
+//#define PORT_PHASE_CODE GPIOx
+//#define PIN_PHASE_CODE GPIO_PIN_x
+#if defined(ENABLE_PHASE_PULSE_CODE) && !defined(PORT_PHASE_CODE)
+#error "ENABLE_PHASE_PULSE_CODE requires setting PORT_PHASE_CODE and PIN_PHASE_CODE!"
+#endif
+
+/// Self-test strap input (pulled up) - pick a pin that's free on your board
+/// revision. Held low at reset, the board boots into the self-test.
+//#define PORT_SELF_TEST_STRAP GPIOx
+//#define PIN_SELF_TEST_STRAP GPIO_PIN_x
+
 #endif
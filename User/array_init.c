@@ -28,6 +28,7 @@
 
 /* Internal Includes */
 #include "array_init.h"
+#include "MCUConfig.h"
 
 /* Library/third-party includes */
 #ifdef OSVR_IR_STM8
@@ -39,9 +40,18 @@
 
 // clang-format off
 
-#ifdef HDK2_HARDWARE
 /*
-Input data producing this mask (HDK2 hardware):
+Input data producing the HDK 1.3 mask (full beacon set):
+/// 1-based indices WRT the tracking software of beacons we'd like to disable.
+/// Masked LEDs determined by BrightNeighbors using distance-cost method, 7 passes (6 LEDs).
+static const auto DISABLED_TARGET0_BEACONS = {33, 13, 18, 32, 34, 5};
+
+/// 1-based indices WRT the tracking software of the beacons on the rear that never light up anyway.
+static const auto DISABLED_TARGET1_BEACONS = {1, 4};
+*/
+
+/*
+Input data producing the HDK 2 mask:
 /// Masked LEDs include the six not present in this hardware revision, with additional masked LEDs
 /// informed by BrightNeighbors using the distance-cost method with 5 passes (4 LEDs). The last LED
 /// suggsted by the algorithm would have been #5, which would have left one side of the HMD quite low
@@ -55,25 +65,8 @@ static const auto DISABLED_TARGET0_BEACONS = {
 /// 1-based indices WRT the tracking software of the beacons on the rear that never light up anyway.
 static const auto DISABLED_TARGET1_BEACONS = {1, 4};
 */
-EEPROM uint8_t default_mask[LED_LINE_LENGTH] = {0xc9, 0xf3, 0x17, 0xff, 0x6f};
-
-#else
-// full beacon set
-/*
-Input data producing this mask:
-/// 1-based indices WRT the tracking software of beacons we'd like to disable.
-/// Masked LEDs determined by BrightNeighbors using distance-cost method, 7 passes (6 LEDs).
-static const auto DISABLED_TARGET0_BEACONS = {33, 13, 18, 32, 34, 5};
-
-/// 1-based indices WRT the tracking software of the beacons on the rear that never light up anyway.
-static const auto DISABLED_TARGET1_BEACONS = {1, 4};
-*/
-EEPROM uint8_t default_mask[LED_LINE_LENGTH] = {0xf1, 0xff, 0xb7, 0xbf, 0x6f};
-#endif
-
 
-#if 1
-EEPROM uint8_t default_pattern_array[PATTERN_COUNT][LED_LINE_LENGTH] =
+static const uint8_t production_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =
 {
     {29,0,32,136,16},
     {9,0,192,26,4},
@@ -92,9 +85,9 @@ EEPROM uint8_t default_pattern_array[PATTERN_COUNT][LED_LINE_LENGTH] =
     {140,144,4,32,64},
     {13,69,0,32,64}
 };
-#else
+
 /// Pattern for testing sync.
-EEPROM uint8_t default_pattern_array[PATTERN_COUNT][LED_LINE_LENGTH] =
+static const uint8_t sync_test_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =
 {
     {0x03,0,0x30,0,0},
     {0x03,0,0x30,0,0},
@@ -113,7 +106,92 @@ EEPROM uint8_t default_pattern_array[PATTERN_COUNT][LED_LINE_LENGTH] =
     {0,0,0,0,0},
     {0,0,0,0,0}
 };
-#endif
+
+/// Codes for device IDs 2 to 4, a bank each, at least 2 apart under any rotation
+/// from every other bank's so the tracker can't take one device's LED for
+/// another's. The production patterns take every code of 3 bright steps, so these
+/// have 5, up to 13 LEDs lit per step against the production patterns' 8. Made
+/// one bank at a time by Desktop/GenerateCodes 40 16 2 13 5 5 --disjoint.
+static const uint8_t device2_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =
+{
+    {33,26,72,140,98},
+    {33,26,82,24,146},
+    {137,152,132,80,24},
+    {168,72,196,80,193},
+    {9,146,17,97,84},
+    {193,66,17,73,138},
+    {74,66,84,10,148},
+    {194,80,69,40,68},
+    {152,36,48,131,36},
+    {18,33,45,164,144},
+    {70,68,34,163,32},
+    {82,33,9,161,33},
+    {20,37,130,22,5},
+    {36,140,10,6,43},
+    {20,133,168,80,10},
+    {36,161,162,4,73}
+};
+
+static const uint8_t device3_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =
+{
+    {41,68,224,68,36},
+    {66,76,20,12,147},
+    {168,40,81,40,70},
+    {129,28,133,136,40},
+    {97,112,144,33,196},
+    {193,160,146,40,69},
+    {36,17,70,50,10},
+    {84,194,72,84,8},
+    {17,73,100,65,88},
+    {70,168,36,80,20},
+    {10,50,10,153,48},
+    {18,21,1,163,224},
+    {12,131,10,67,137},
+    {152,130,146,130,34},
+    {164,1,41,6,19},
+    {18,6,41,148,129}
+};
+
+static const uint8_t device4_patterns[PATTERN_COUNT][LED_LINE_LENGTH] =
+{
+    {33,198,16,180,16},
+    {10,19,18,66,21},
+    {145,136,73,80,17},
+    {40,5,19,17,135},
+    {133,130,72,98,84},
+    {20,12,137,73,44},
+    {73,40,100,34,98},
+    {88,66,10,140,66},
+    {82,48,162,33,98},
+    {5,26,164,162,160},
+    {44,65,82,18,145},
+    {146,168,64,13,136},
+    {130,69,5,69,12},
+    {68,49,133,24,9},
+    {162,68,168,136,200},
+    {96,176,52,132,34}
+};
+
+const PatternBank pattern_banks[PATTERN_BANK_COUNT] =
+{
+    /* PATTERN_BANK_HDK1 */      {production_patterns, {0xf1, 0xff, 0xb7, 0xbf, 0x6f}},
+    /* PATTERN_BANK_HDK2 */      {production_patterns, {0xc9, 0xf3, 0x17, 0xff, 0x6f}},
+    /* PATTERN_BANK_SYNC_TEST */ {sync_test_patterns,  {0xff, 0xff, 0xff, 0xff, 0xff}},
+    /* PATTERN_BANK_DEVICE2 */   {device2_patterns,    {0xff, 0xff, 0xff, 0xff, 0xff}},
+    /* PATTERN_BANK_DEVICE3 */   {device3_patterns,    {0xff, 0xff, 0xff, 0xff, 0xff}},
+    /* PATTERN_BANK_DEVICE4 */   {device4_patterns,    {0xff, 0xff, 0xff, 0xff, 0xff}}
+};
+
+/// Device 1 keeps the production patterns the tracker knows; the others take a
+/// bank of their own, which keeps them apart at any phase. The phases, as far
+/// apart as possible, only add distance for a tracker that knows them.
+const DeviceSlot device_slots[DEVICE_SLOT_COUNT] =
+{
+    /* device 1 */ {DEFAULT_PATTERN_BANK, 0},
+    /* device 2 */ {PATTERN_BANK_DEVICE2, 8},
+    /* device 3 */ {PATTERN_BANK_DEVICE3, 4},
+    /* device 4 */ {PATTERN_BANK_DEVICE4, 12}
+};
 // clang-format on
 
 NEAR uint8_t pattern_array[PATTERN_COUNT][LED_LINE_LENGTH];
@@ -122,6 +200,18 @@ NEAR uint8_t ir_led_driver_buffer[PATTERN_COUNT][DRIVER_BUFFER_LENGTH];
 
 NEAR uint8_t driver_mask[DRIVER_BUFFER_LENGTH];
 
+/// The RAM tables, as the active pointers take them.
+#define RAM_PATTERN_ROWS ((uint8_t const(*)[LED_LINE_LENGTH])pattern_array)
+#define RAM_DRIVER_FRAMES ((uint8_t const(*)[DRIVER_BUFFER_LENGTH])ir_led_driver_buffer)
+
+uint8_t const (*active_pattern_rows)[LED_LINE_LENGTH]       = RAM_PATTERN_ROWS;
+uint8_t const (*active_driver_frames)[DRIVER_BUFFER_LENGTH] = RAM_DRIVER_FRAMES;
+uint8_t const *active_driver_mask                           = driver_mask;
+
+uint8_t active_pattern_bank = DEFAULT_PATTERN_BANK;
+uint8_t active_mask_bank    = DEFAULT_PATTERN_BANK;
+uint8_t pattern_phase       = 0;
+
 void expand_array(uint8_t *buffer, uint8_t *value)
 {
 
@@ -158,15 +248,33 @@ void expand_array(uint8_t *buffer, uint8_t *value)
 
 void line_array_init(uint8_t index, uint8_t *value) { expand_array(ir_led_driver_buffer[index], value); }
 
-void default_array_init(void)
+void default_array_init(void) { bank_array_init(DEFAULT_PATTERN_BANK, DEFAULT_PATTERN_BANK); }
+
+uint8_t bank_array_init(uint8_t pattern_bank, uint8_t mask_bank)
 {
   uint8_t i;
+  if (pattern_bank >= PATTERN_BANK_COUNT || mask_bank >= PATTERN_BANK_COUNT)
+  {
+    return 0;
+  }
+  active_pattern_bank = pattern_bank;
+  active_mask_bank    = mask_bank;
+#ifdef ENABLE_FLASH_FRAMES
+  if (pattern_banks[pattern_bank].patterns == pattern_banks[FLASH_FRAMES_BANK].patterns)
+  {
+    // Already expanded: nothing to copy until something is written.
+    active_pattern_rows  = pattern_banks[pattern_bank].patterns;
+    active_driver_frames = flash_driver_frames;
+    active_driver_mask   = flash_driver_masks[mask_bank];
+    return 1;
+  }
+#endif
   for (i = 0; i < PATTERN_COUNT; i++)
   {
     uint8_t j;
     for (j = 0; j < LED_LINE_LENGTH; j++)
     {
-      pattern_array[i][j] = default_pattern_array[i][j];
+      pattern_array[i][j] = pattern_banks[pattern_bank].patterns[i][j];
     }
     line_array_init(i, (uint8_t *)pattern_array[i]);
   }
@@ -175,8 +283,55 @@ void default_array_init(void)
     uint8_t j;
     for (j = 0; j < LED_LINE_LENGTH; j++)
     {
-      mask[j] = default_mask[j];
+      mask[j] = pattern_banks[mask_bank].mask[j];
     }
     expand_array(driver_mask, mask);
   }
+  active_pattern_rows  = RAM_PATTERN_ROWS;
+  active_driver_frames = RAM_DRIVER_FRAMES;
+  active_driver_mask   = driver_mask;
+  return 1;
+}
+
+void array_make_writable(void)
+{
+#ifdef ENABLE_FLASH_FRAMES
+  uint8_t i, j;
+  if (active_driver_mask == driver_mask)
+  {
+    return;
+  }
+  for (i = 0; i < PATTERN_COUNT; i++)
+  {
+    for (j = 0; j < LED_LINE_LENGTH; j++)
+    {
+      pattern_array[i][j] = active_pattern_rows[i][j];
+    }
+    for (j = 0; j < DRIVER_BUFFER_LENGTH; j++)
+    {
+      ir_led_driver_buffer[i][j] = active_driver_frames[i][j];
+    }
+  }
+  for (j = 0; j < DRIVER_BUFFER_LENGTH; j++)
+  {
+    driver_mask[j] = active_driver_mask[j];
+  }
+  active_pattern_rows  = RAM_PATTERN_ROWS;
+  active_driver_frames = RAM_DRIVER_FRAMES;
+  active_driver_mask   = driver_mask;
+#endif // ENABLE_FLASH_FRAMES
+}
+
+uint8_t device_array_init(uint8_t device_id)
+{
+  if (device_id == 0 || device_id > DEVICE_ID_MAX)
+  {
+    return 0;
+  }
+  if (!bank_array_init(device_slots[device_id - 1].pattern_bank, active_mask_bank))
+  {
+    return 0;
+  }
+  pattern_phase = device_slots[device_id - 1].phase;
+  return 1;
 }
@@ -31,21 +31,125 @@
 
 #include "Config.h" // for uint8_t without conflicts
 
-#define LED_LINE_LENGTH 5
+/// LEDs driven, a multiple of 8 - define it (and DRIVER_CHAIN_BITS) on the
+/// compiler command line to build for another object. The compiled-in pattern
+/// banks are the HDK's 40 LEDs: any more stay dark and masked until given
+/// patterns ("PW") and a mask bank of their own.
+#ifndef LED_COUNT
+#define LED_COUNT 40
+#endif
+
+/// Driver outputs shifted through per frame: the whole chain, whether or not
+/// every output has an LED - 96 on the EVB (six 16-output drivers).
+#ifndef DRIVER_CHAIN_BITS
+#define DRIVER_CHAIN_BITS 96
+#endif
+
+#define LED_LINE_LENGTH (LED_COUNT / 8)
+/// Each LED is wired to two adjacent driver outputs.
 #define DRIVER_BUFFER_LENGTH (LED_LINE_LENGTH * 2)
+/// Zero bytes shifted in ahead of each frame, for the outputs past the LEDs.
+#define DRIVER_PADDING_LENGTH (DRIVER_CHAIN_BITS / 8 - DRIVER_BUFFER_LENGTH)
 #define PATTERN_COUNT 16
 
+#if LED_COUNT % 8 != 0 || DRIVER_CHAIN_BITS % 8 != 0
+#error "LED_COUNT and DRIVER_CHAIN_BITS must be multiples of 8!"
+#endif
+#if DRIVER_PADDING_LENGTH < 0
+#error "DRIVER_CHAIN_BITS is too short for two outputs per LED!"
+#endif
+
+/// Pattern banks compiled into flash: a complete pattern table plus the mask for
+/// one hardware revision, so a single image can serve every board.
+enum
+{
+  /// Production patterns, masked for the full beacon set (HDK 1.3)
+  PATTERN_BANK_HDK1 = 0,
+  /// Production patterns, masked for the HDK 2 beacons
+  PATTERN_BANK_HDK2 = 1,
+  /// Pattern for testing sync, nothing masked
+  PATTERN_BANK_SYNC_TEST = 2,
+  /// Codes for device ID 2, apart from every other bank's, nothing masked
+  PATTERN_BANK_DEVICE2 = 3,
+  /// Codes for device ID 3, likewise
+  PATTERN_BANK_DEVICE3 = 4,
+  /// Codes for device ID 4, likewise
+  PATTERN_BANK_DEVICE4 = 5,
+  PATTERN_BANK_COUNT
+};
+
+#ifdef HDK2_HARDWARE
+#define DEFAULT_PATTERN_BANK PATTERN_BANK_HDK2
+#else
+#define DEFAULT_PATTERN_BANK PATTERN_BANK_HDK1
+#endif
+
+/// Bank whose patterns driver_frames.c holds already expanded (see
+/// ENABLE_FLASH_FRAMES) - shared by every bank with the same pattern table.
+#define FLASH_FRAMES_BANK PATTERN_BANK_HDK1
+
+typedef struct PatternBank_
+{
+  uint8_t const (*patterns)[LED_LINE_LENGTH];
+  uint8_t mask[LED_LINE_LENGTH];
+} PatternBank;
+
+/// Several devices in front of one camera each take a device ID, mapped to a
+/// pattern bank and a phase (rotation of the pattern sequence) that keep their
+/// codes apart - see Desktop/ConfusionAnalyzer. Device ID 0 is a standalone
+/// device: boot bank, no phase offset.
+typedef struct DeviceSlot_
+{
+  uint8_t pattern_bank;
+  uint8_t phase;
+} DeviceSlot;
+
+#define DEVICE_SLOT_COUNT 4
+#define DEVICE_ID_MAX DEVICE_SLOT_COUNT
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
 
+void expand_array(uint8_t *buffer, uint8_t *value);
 void line_array_init(uint8_t index, uint8_t *value);
 void default_array_init(void);
 
+/// Loads the patterns of one bank and the mask of another (usually the same one)
+/// - returns 0, changing nothing, if either is out of range.
+uint8_t bank_array_init(uint8_t pattern_bank, uint8_t mask_bank);
+
+/// Loads the pattern bank of the slot for device ID 1 to DEVICE_ID_MAX, keeping
+/// the active mask bank, and sets its phase - returns 0 for any other ID.
+uint8_t device_array_init(uint8_t device_id);
+
+/// Copies the tables in use into the RAM ones below, if they're still the flash
+/// ones, and switches to those - call before writing any of them.
+void array_make_writable(void);
+
+extern const PatternBank pattern_banks[PATTERN_BANK_COUNT];
+extern const DeviceSlot device_slots[DEVICE_SLOT_COUNT];
+extern uint8_t active_pattern_bank;
+extern uint8_t active_mask_bank;
+
+/// Offset added to the pattern index on every sync.
+extern uint8_t pattern_phase;
+
 extern NEAR uint8_t ir_led_driver_buffer[PATTERN_COUNT][DRIVER_BUFFER_LENGTH];
 extern NEAR uint8_t pattern_array[PATTERN_COUNT][LED_LINE_LENGTH];
 extern NEAR uint8_t driver_mask[DRIVER_BUFFER_LENGTH];
 
+/// The tables in use: the RAM ones above, or with ENABLE_FLASH_FRAMES the flash
+/// ones below until array_make_writable().
+extern uint8_t const (*active_pattern_rows)[LED_LINE_LENGTH];
+extern uint8_t const (*active_driver_frames)[DRIVER_BUFFER_LENGTH];
+extern uint8_t const *active_driver_mask;
+
+/// Generated by Desktop/GenerateFrames into driver_frames.c: the patterns of
+/// FLASH_FRAMES_BANK and the mask of every bank, expanded.
+extern const uint8_t flash_driver_frames[PATTERN_COUNT][DRIVER_BUFFER_LENGTH];
+extern const uint8_t flash_driver_masks[PATTERN_BANK_COUNT][DRIVER_BUFFER_LENGTH];
+
 #ifdef __cplusplus
 };     // extern "C"
 #endif // __cplusplus
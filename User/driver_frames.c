@@ -0,0 +1,78 @@
+/** @file
+    @brief Driver frames precomputed from the pattern banks in array_init.c, for
+   ENABLE_FLASH_FRAMES.
+
+    Generated by Desktop/GenerateFrames - don't edit, regenerate it after
+   changing the patterns or masks (the desktop build checks it's current).
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "array_init.h"
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+#ifdef ENABLE_FLASH_FRAMES
+
+// clang-format off
+/// The patterns of FLASH_FRAMES_BANK (PATTERN_BANK_HDK1), expanded.
+const uint8_t flash_driver_frames[16][10] =
+{
+    {0xf3, 0x03, 0x00, 0x00, 0x00, 0x0c, 0xc0, 0xc0, 0x00, 0x03},
+    {0xc3, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xcc, 0x03, 0x30, 0x00},
+    {0x33, 0x30, 0xc0, 0x30, 0x03, 0x00, 0x00, 0x30, 0x30, 0x00},
+    {0x0c, 0xcc, 0x00, 0x00, 0xf0, 0x00, 0x0c, 0x00, 0x0f, 0x00},
+    {0x0c, 0x00, 0x00, 0x0f, 0x0c, 0x03, 0x03, 0x00, 0xcc, 0x00},
+    {0x0c, 0x03, 0x00, 0x00, 0x33, 0x00, 0x0c, 0x03, 0xc0, 0x00},
+    {0x0f, 0x00, 0x0c, 0x30, 0x00, 0x03, 0x03, 0x03, 0x00, 0x0c},
+    {0x00, 0x00, 0x33, 0x0c, 0x03, 0x00, 0x00, 0xc0, 0x30, 0x0c},
+    {0x00, 0x3c, 0xc0, 0xc0, 0x0c, 0x0c, 0x00, 0xf0, 0x00, 0x00},
+    {0x0c, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x33, 0x3c, 0xc0, 0x0c},
+    {0x00, 0xc3, 0x0c, 0x00, 0x0c, 0x3c, 0x00, 0x00, 0x0c, 0xc0},
+    {0x00, 0x00, 0xc3, 0xc3, 0xc0, 0xc0, 0x30, 0x00, 0x03, 0x00},
+    {0x00, 0x3c, 0x30, 0x0c, 0x00, 0x30, 0x30, 0x00, 0x03, 0x03},
+    {0xf0, 0x00, 0x0c, 0x00, 0x00, 0xc3, 0xc0, 0x00, 0x00, 0x33},
+    {0xf0, 0xc0, 0x00, 0xc3, 0x30, 0x00, 0x00, 0x0c, 0x00, 0x30},
+    {0xf3, 0x00, 0x33, 0x30, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x30}
+};
+
+const uint8_t flash_driver_masks[6][10] =
+{
+    /* PATTERN_BANK_HDK1 */ {0x03, 0xff, 0xff, 0xff, 0x3f, 0xcf, 0xff, 0xcf, 0xff, 0x3c},
+    /* PATTERN_BANK_HDK2 */ {0xc3, 0xf0, 0x0f, 0xff, 0x3f, 0x03, 0xff, 0xff, 0xff, 0x3c},
+    /* PATTERN_BANK_SYNC_TEST */ {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+    /* PATTERN_BANK_DEVICE2 */ {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+    /* PATTERN_BANK_DEVICE3 */ {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+    /* PATTERN_BANK_DEVICE4 */ {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}
+};
+// clang-format on
+
+#endif // ENABLE_FLASH_FRAMES
@@ -0,0 +1,86 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "event_queue.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+#define EVENT_QUEUE_DEPTH_MASK (EVENT_QUEUE_DEPTH - 1)
+
+/// Volatile too, so the compiler can't move slot accesses past the index updates.
+static NEAR volatile Event _events[EVENT_QUEUE_DEPTH];
+/// Free-running: the difference is the number of events queued.
+static volatile uint8_t _write = 0;
+static volatile uint8_t _read  = 0;
+
+void event_queue_init(void)
+{
+  _write = 0;
+  _read  = 0;
+}
+
+uint8_t event_queue_push(uint8_t type, uint8_t arg)
+{
+  uint8_t write = _write;
+  volatile Event *event;
+  if ((uint8_t)(write - _read) == EVENT_QUEUE_DEPTH)
+  {
+    return FALSE;
+  }
+  event       = &_events[write & EVENT_QUEUE_DEPTH_MASK];
+  event->type = type;
+  event->arg  = arg;
+  // Publish only once the slot is complete.
+  _write = write + 1;
+  return TRUE;
+}
+
+uint8_t event_queue_pop(Event *out)
+{
+  uint8_t read = _read;
+  volatile Event *event;
+  if (read == _write)
+  {
+    return FALSE;
+  }
+  event     = &_events[read & EVENT_QUEUE_DEPTH_MASK];
+  out->type = event->type;
+  out->arg  = event->arg;
+  // Free the slot only once it's been copied.
+  _read = read + 1;
+  return TRUE;
+}
+
+uint8_t event_queue_is_empty(void) { return _read == _write; }
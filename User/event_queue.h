@@ -0,0 +1,90 @@
+/** @file
+    @brief Header for the single-producer, single-consumer event queue the
+   interrupt handlers use to hand work (uploads, settings commits) to the main loop
+
+    Must be c-safe!
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_event_queue_h_GUID_A33C851B_6DBA_40DE_892E_8B026330062F
+#define INCLUDED_event_queue_h_GUID_A33C851B_6DBA_40DE_892E_8B026330062F
+
+/* Internal Includes */
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Event types.
+enum
+{
+  /// Latch the dim frame for a driver byte group - arg: group
+  EVENT_UPLOAD_BLANK = 0,
+  /// A flash process finished: latch the next pattern row - arg: nonzero if the
+  /// process was simulated, which latches dim group 0 instead.
+  EVENT_UPLOAD_PATTERN,
+  /// Latch a sequencer frame - arg: SEQ_FRAME_* selector
+  EVENT_UPLOAD_FRAME,
+  /// A flash process finished: settings changed since may take effect.
+  EVENT_COMMIT_CONFIG,
+  /// Latch the level plane row of the pattern row latched last - arg: nonzero
+  /// if the process was simulated, which latches nothing lit instead.
+  EVENT_UPLOAD_LEVEL
+};
+
+/// Number of events held - must be a power of two. A process has at most an
+/// upload outstanding, plus the pattern and commit events of the previous one
+/// if the main loop is running late.
+#define EVENT_QUEUE_DEPTH 4
+
+#if (EVENT_QUEUE_DEPTH & (EVENT_QUEUE_DEPTH - 1)) != 0
+#error "EVENT_QUEUE_DEPTH must be a power of two!"
+#endif
+
+typedef struct Event_
+{
+  uint8_t type;
+  uint8_t arg;
+} Event;
+
+/// Call with interrupts disabled, or before they're enabled.
+void event_queue_init(void);
+
+/// Queues an event - returns FALSE if the queue is full. Interrupt handlers
+/// only: they don't nest, so there's a single producer.
+uint8_t event_queue_push(uint8_t type, uint8_t arg);
+
+/// Takes the oldest event - returns FALSE if there are none. Main loop only.
+/// Neither end needs locking: each index is written by one side only, after
+/// the slot it covers.
+uint8_t event_queue_pop(Event *out);
+
+uint8_t event_queue_is_empty(void);
+
+#endif // INCLUDED_event_queue_h_GUID_A33C851B_6DBA_40DE_892E_8B026330062F
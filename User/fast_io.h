@@ -0,0 +1,95 @@
+/** @file
+    @brief Header with register-level equivalents of the StdPeriph GPIO and
+   timer calls made in the interrupt handlers.
+
+    With constant arguments each of these compiles to one or two instructions
+    (BSET/BRES/BCPL or MOV), where the library call also pays for loading the
+    arguments, CALL and RET. Estimated from the STM8 instruction timings, in
+    cycles of the 16MHz clock (library call -> macro):
+
+    - GPIO_WriteHigh/GPIO_WriteLow/GPIO_WriteReverse: ~14 -> 1
+    - TIM1_SetCounter: ~14 -> ~6 (counter in a variable), 2 (constant)
+    - TIM1_Cmd: ~12 -> 1
+    - TIM1_ClearITPendingBit: ~11 -> 1
+
+    Re-measure on the test points before trusting these to the cycle; the boot
+    calibration (ENABLE_CALIBRATION) picks up the shorter handlers either way.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_fast_io_h_GUID_6B4FC9AD_2556_4C14_BF94_8D3944BD0BA6
+#define INCLUDED_fast_io_h_GUID_6B4FC9AD_2556_4C14_BF94_8D3944BD0BA6
+
+/* Internal Includes */
+/* none */
+
+/* Library/third-party includes */
+#include "stm8s.h"
+
+/* Standard includes */
+/* none */
+
+/// GPIO_WriteHigh()
+#define FAST_GPIO_HIGH(PORT, PIN) ((PORT)->ODR |= (uint8_t)(PIN))
+/// GPIO_WriteLow()
+#define FAST_GPIO_LOW(PORT, PIN) ((PORT)->ODR &= (uint8_t)(~(uint8_t)(PIN)))
+/// GPIO_WriteReverse()
+#define FAST_GPIO_TOGGLE(PORT, PIN) ((PORT)->ODR ^= (uint8_t)(PIN))
+
+/// TIM1_SetCounter() - high byte first, as the hardware requires.
+#define FAST_TIM1_SET_COUNTER(COUNTER)                                                                                 \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    uint16_t fast_io_counter_ = (COUNTER);                                                                             \
+    TIM1->CNTRH               = (uint8_t)(fast_io_counter_ >> 8);                                                      \
+    TIM1->CNTRL               = (uint8_t)(fast_io_counter_);                                                           \
+  } while (0)
+
+/// TIM1_Cmd(ENABLE)
+#define FAST_TIM1_ENABLE() (TIM1->CR1 |= TIM1_CR1_CEN)
+/// TIM1_Cmd(DISABLE)
+#define FAST_TIM1_DISABLE() (TIM1->CR1 &= (uint8_t)(~TIM1_CR1_CEN))
+/// TIM1_ClearITPendingBit(TIM1_IT_UPDATE) - writing 0 clears, writing 1 has no effect.
+#define FAST_TIM1_CLEAR_UPDATE() (TIM1->SR1 = (uint8_t)(~TIM1_SR1_UIF))
+
+/// TIM2_SetCounter(0)
+#define FAST_TIM2_RESET_COUNTER()                                                                                      \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    TIM2->CNTRH = 0;                                                                                                   \
+    TIM2->CNTRL = 0;                                                                                                   \
+  } while (0)
+/// COUNTER = TIM2_GetCounter() - high byte first, which latches the low byte.
+#define FAST_TIM2_GET_COUNTER(COUNTER)                                                                                 \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    uint8_t fast_io_high_ = TIM2->CNTRH;                                                                               \
+    (COUNTER)             = (uint16_t)(((uint16_t)fast_io_high_ << 8) | TIM2->CNTRL);                                  \
+  } while (0)
+/// TIM2_ClearITPendingBit(TIM2_IT_UPDATE)
+#define FAST_TIM2_CLEAR_UPDATE() (TIM2->SR1 = (uint8_t)(~TIM2_SR1_UIF))
+
+#endif // INCLUDED_fast_io_h_GUID_6B4FC9AD_2556_4C14_BF94_8D3944BD0BA6
@@ -1,3 +1,3 @@
 pushd "%~dp0"
-clang-format -i -style=file array_init.c array_init.h Config.h main.c main.h uart_protocol.c uart_protocol.h MCUConfig.h
+clang-format -i -style=file array_init.c array_init.h Config.h event_queue.c event_queue.h fast_io.h frame_stream.c frame_stream.h main.c main.h multi_level.c multi_level.h perf_counters.c perf_counters.h phase_report.h sequencer.c sequencer.h self_test.c self_test.h settings.c settings.h sync_rate.c sync_rate.h trace.c trace.h uart_protocol.c uart_protocol.h MCUConfig.h
 popd
@@ -0,0 +1,102 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "frame_stream.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+#ifdef ENABLE_FRAME_STREAM
+
+#define FRAME_STREAM_DEPTH_MASK (FRAME_STREAM_DEPTH - 1)
+
+static NEAR uint8_t _frames[FRAME_STREAM_DEPTH][LED_LINE_LENGTH];
+static uint8_t _count = 0;
+static uint8_t _write = 0;
+static uint8_t _read  = 0;
+
+/// Whether the previous upload came from the FIFO, for underrun detection.
+static uint8_t _streaming = 0;
+static uint16_t _underruns = 0;
+
+void frame_stream_init(void)
+{
+  _count     = 0;
+  _write     = 0;
+  _read      = 0;
+  _streaming = 0;
+  _underruns = 0;
+}
+
+uint8_t frame_stream_push(uint8_t *value)
+{
+  uint8_t j;
+  if (_count == FRAME_STREAM_DEPTH)
+  {
+    return FALSE;
+  }
+  for (j = 0; j < LED_LINE_LENGTH; j++)
+  {
+    _frames[_write][j] = value[j];
+  }
+  _write++;
+  _write &= FRAME_STREAM_DEPTH_MASK;
+  _count++;
+  return TRUE;
+}
+
+uint8_t frame_stream_pop_expanded(uint8_t *buffer)
+{
+  if (_count == 0)
+  {
+    if (_streaming && _underruns != 0xFFFF)
+    {
+      _underruns++;
+    }
+    _streaming = 0;
+    return FALSE;
+  }
+  expand_array(buffer, _frames[_read]);
+  _read++;
+  _read &= FRAME_STREAM_DEPTH_MASK;
+  _count--;
+  _streaming = 1;
+  return TRUE;
+}
+
+uint8_t frame_stream_count(void) { return _count; }
+
+uint16_t frame_stream_underruns(void) { return _underruns; }
+
+#endif // ENABLE_FRAME_STREAM
@@ -0,0 +1,70 @@
+/** @file
+    @brief Header for a FIFO of LED frames streamed from the host ahead of each sync
+
+    Must be c-safe!
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_frame_stream_h_GUID_4C46F093_52BD_4317_9E73_8DC7487CF098
+#define INCLUDED_frame_stream_h_GUID_4C46F093_52BD_4317_9E73_8DC7487CF098
+
+/* Internal Includes */
+#include "MCUConfig.h"
+#include "array_init.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+#ifdef ENABLE_FRAME_STREAM
+
+#if (FRAME_STREAM_DEPTH & (FRAME_STREAM_DEPTH - 1)) != 0
+#error "FRAME_STREAM_DEPTH must be a power of two!"
+#endif
+
+/// Both ends of the FIFO are used from the main loop only (UART parsing pushes,
+/// pattern upload pops), so no interrupt locking is needed.
+void frame_stream_init(void);
+
+/// Queue a LED_LINE_LENGTH-byte frame - returns FALSE if the FIFO is full.
+uint8_t frame_stream_push(uint8_t *value);
+
+/// If a frame is queued, expand it into buffer (DRIVER_BUFFER_LENGTH bytes) and
+/// return TRUE. Otherwise return FALSE, so the caller falls back to the stored
+/// pattern table.
+uint8_t frame_stream_pop_expanded(uint8_t *buffer);
+
+uint8_t frame_stream_count(void);
+
+/// Number of uploads that found the FIFO empty right after having streamed a
+/// frame, i.e. the host fell behind. Saturates rather than wrapping.
+uint16_t frame_stream_underruns(void);
+
+#endif // ENABLE_FRAME_STREAM
+
+#endif // INCLUDED_frame_stream_h_GUID_4C46F093_52BD_4317_9E73_8DC7487CF098
@@ -30,6 +30,18 @@
 #include "MCUConfig.h"
 
 #include "array_init.h"
+#include "event_queue.h"
+#include "fast_io.h"
+#include "frame_stream.h"
+#include "main.h"
+#include "multi_level.h"
+#include "perf_counters.h"
+#include "phase_report.h"
+#include "self_test.h"
+#include "sequencer.h"
+#include "settings.h"
+#include "sync_rate.h"
+#include "trace.h"
 #include "uart_protocol.h"
 
 /* Library/third-party includes */
@@ -49,9 +61,6 @@
 #endif
 
 // This should be a production build.
-#ifdef SYNC_INTERVAL
-#error "SYNC_INTERVAL cannot be defined in a production build!"
-#endif
 /// @todo is this the policy we want?
 #ifndef ENABLE_SIMULATION
 #error "ENABLE_SIMULATION must be defined in a production build!"
@@ -60,6 +69,27 @@
 
 #define MCU_CLOCK 16000000
 static uint8_t index_16 = 15;
+/// The pattern row latched for the coming (or current) flash process - written by
+/// the main loop, read by the handlers.
+static volatile uint8_t _latched_index = 0;
+
+#if defined(ENABLE_PHASE_REPORT) || defined(ENABLE_PHASE_PULSE_CODE)
+#define PHASE_REPORT_IN_USE
+/// Set by the interrupt starting a flash process, sent by the main loop.
+static volatile uint8_t _phaseReport = 0;
+#endif
+
+#ifdef ENABLE_PHASE_PULSE_CODE
+/// Burst of row + 1 pulses, about a microsecond each.
+static void Send_phase_pulse_code(uint8_t row)
+{
+  do
+  {
+    GPIO_WriteHigh(PORT_PHASE_CODE, PIN_PHASE_CODE);
+    GPIO_WriteLow(PORT_PHASE_CODE, PIN_PHASE_CODE);
+  } while (row--);
+}
+#endif // ENABLE_PHASE_PULSE_CODE
 
 static void Delay(uint16_t n)
 {
@@ -120,16 +150,27 @@ static void SPI_SendByte(uint8_t data)
   SPI->DR = data;
 }
 
-static void Send_array_spi_data()
+/// Zeros for the driver outputs past the LEDs, shifted in first so the frame
+/// ends up at the near end of the chain - two bytes on the 96 bit EVB.
+static void SPI_SendPadding()
+{
+  uint8_t k = DRIVER_PADDING_LENGTH;
+  while (k)
+  {
+    k--;
+    SPI_SendByte((uint8_t)0x00);
+  }
+}
+
+/// Shift an expanded (DRIVER_BUFFER_LENGTH) frame, masked, into the drivers and latch it.
+static void Send_driver_data(uint8_t const *ptr)
 {
   GPIO_WriteLow(PORT_LATCH, PIN_LATCH); // Prepare driver latch enable for the next data latch
 
-  SPI_SendByte((uint8_t)0x00); // for 96 bit EVB
-  SPI_SendByte((uint8_t)0x00); // for 96 bit EVB
+  SPI_SendPadding();
 
-  uint8_t *ptr     = ir_led_driver_buffer[index_16];
-  uint8_t *maskptr = driver_mask;
-  uint8_t k        = DRIVER_BUFFER_LENGTH;
+  uint8_t const *maskptr = active_driver_mask;
+  uint8_t k              = DRIVER_BUFFER_LENGTH;
   while (k)
   {
     k--;
@@ -144,45 +185,123 @@ static void Send_array_spi_data()
   GPIO_WriteHigh(PORT_LATCH, PIN_LATCH);
 }
 
+#ifdef ENABLE_SELF_TEST
+/// Group argument for the self-test's pattern pulse frame.
+#define SELF_TEST_BRIGHT 0xFF
+
+/// Latch the LEDs of the current self-test step: all of them for the pattern
+/// pulse (SELF_TEST_BRIGHT) in a bright step, or those in the given driver byte
+/// group for its dim pulse.
+static void Send_self_test_spi_data(uint8_t group)
+{
+  uint8_t leds[LED_LINE_LENGTH];
+  uint8_t buffer[DRIVER_BUFFER_LENGTH];
+  uint8_t bright = self_test_step_frame(self_test_step(), leds);
+  uint8_t i;
+  for (i = 0; i < LED_LINE_LENGTH; i++)
+  {
+    if (group == SELF_TEST_BRIGHT ? !bright : i != group)
+      leds[i] = 0;
+  }
+  expand_array(buffer, leds);
+  Send_driver_data(buffer);
+}
+#endif // ENABLE_SELF_TEST
+
+#ifdef ENABLE_MULTI_LEVEL
+/// Latch the level plane row for the level pulse.
+static void Send_level_spi_data(uint8_t row)
+{
+  uint8_t buffer[DRIVER_BUFFER_LENGTH];
+  expand_array(buffer, level_array[row]);
+  Send_driver_data(buffer);
+}
+#endif // ENABLE_MULTI_LEVEL
+
+static void Send_array_spi_data(uint8_t row)
+{
+  uint8_t const *ptr = active_driver_frames[row];
+#ifdef ENABLE_FRAME_STREAM
+  // A frame streamed from the host takes precedence over the stored table.
+  uint8_t streamed[DRIVER_BUFFER_LENGTH];
+  if (frame_stream_pop_expanded(streamed))
+  {
+    ptr = streamed;
+  }
+#endif // ENABLE_FRAME_STREAM
+
+  Send_driver_data(ptr);
+}
+
+/// Flash process state - owned by the interrupt handlers: the main loop never
+/// writes it, and learns what to do from the event queue instead.
 typedef enum {
-  /// Pattern shifted into LEDs, ready to display
+  /// Idle since boot
   STATE_PROCESS_AWAITING_START,
   STATE_IN_STARTUP_DELAY,
   /// Currently displaying LEDs as indicated by the pattern
   STATE_PATTERN_ON,
-  /// the following 3 have substates, indicated by _subState, for each of
+  /// the following 2 have substates, indicated by _subState, for each of
   /// LED_LINE_LENGTH, since dim illumination
   /// happens in byte-sized blocks.
-  STATE_BETWEEN_PULSES_AWAITING_BLANK_UPLOAD,
-  STATE_BETWEEN_PULSES_AWAITING_TIMER,
+  /// All off, dim frame upload requested, awaiting the timer
+  STATE_BETWEEN_PULSES,
   /// All off except a single byte of LEDs, for dim illumination
   STATE_DIM_PULSE_ON,
   /// Lockout spurious sync signals following LED process
   STATE_POST_PROCESS_LOCKOUT,
-  /// All dim illumination cycles and lockout completed, awaiting pattern
-  /// illumination.
-  STATE_AWAITING_PATTERN
+  /// All dim illumination cycles and lockout completed, next pattern upload
+  /// requested.
+  STATE_AWAITING_PATTERN,
+  /// All dim illumination cycles completed with more processes due for this
+  /// sync (the multiplier): next pattern upload requested, awaiting the timer.
+  STATE_BETWEEN_MULTIPLES,
+  /// All off after the pattern pulse, level plane upload requested, awaiting
+  /// the timer
+  STATE_BEFORE_LEVEL_PULSE,
+  /// LEDs of the level plane on, for multi-level brightness
+  STATE_LEVEL_PULSE_ON
 } State_t;
 
 static State_t _procState = STATE_PROCESS_AWAITING_START;
 
 static uint8_t _subState = 0;
 
-static void Send_blanks_spi_data()
+/// For the main loop's rare looks at _procState, with interrupts disabled.
+#define PROC_STATE_NOW (*(volatile State_t *)&_procState)
+
+/// Upload handshake: the handlers count the uploads they've queued, the main loop
+/// the ones it has latched. Each counter has a single writer, so no locking.
+static volatile uint8_t _uploadsRequested = 0;
+static volatile uint8_t _uploadsDone      = 0;
+
+#define UPLOAD_PENDING() (_uploadsRequested != _uploadsDone)
+
+/// Interrupt handlers only. If the queue is somehow full, the upload is dropped
+/// and the frame already latched shows again, as with a late upload.
+static void request_upload(uint8_t type, uint8_t arg)
+{
+  if (event_queue_push(type, arg))
+  {
+    _uploadsRequested++;
+  }
+}
+
+/// Latch the "dim" frame: every LED off except the (masked) driver byte group given.
+static void Send_blanks_spi_data(uint8_t group)
 {
   GPIO_WriteLow(PORT_LATCH, PIN_LATCH); // Prepare driver latch enable for the next data latch
 
-  SPI_SendByte((uint8_t)0x00); // for 96 bit EVB
-  SPI_SendByte((uint8_t)0x00); // for 96 bit EVB
+  SPI_SendPadding();
   int i;
   for (i = 0; i < LED_LINE_LENGTH; i++)
   {
-    if (i == _subState)
+    if (i == group)
     {
       /// @todo For one "blank" interval per process, each LED is illuminated,
       /// to provide "dim" - is this correct understanding?
-      SPI_SendByte((uint8_t)driver_mask[i * 2]);
-      SPI_SendByte((uint8_t)driver_mask[i * 2 + 1]);
+      SPI_SendByte((uint8_t)active_driver_mask[i * 2]);
+      SPI_SendByte((uint8_t)active_driver_mask[i * 2 + 1]);
     }
     else
     {
@@ -205,19 +324,129 @@ static void Send_blanks_spi_data()
 static uint16_t _flash_blank_period;
 static uint16_t _flash_interval_period;
 static uint16_t _flash_period;
+#ifdef ENABLE_MULTI_LEVEL
+/// 0 for no level pulse.
+static uint16_t _flash_level_period = 0;
+#endif
 
 /// @}
+
+/// What the handlers run from - only changed by commit_config(), between
+/// processes, so no process mixes old and new periods.
 static uint16_t _flash_blank_period_as_timer;
 static uint16_t _flash_interval_period_as_timer;
 static uint16_t _flash_period_as_timer;
+#ifdef ENABLE_MULTI_LEVEL
+/// 0 for no level pulse.
+static uint16_t _flash_level_period_as_timer = 0;
+#endif
+
+/// Set when a period has changed since the last commit.
+static uint8_t _config_staged = FALSE;
+
+/// Duration (usec) of a flash process from bright pulse on to the last dim
+/// pulse off, as committed - for the sync rate budget.
+static uint16_t _process_us;
+
+/// Start out as measured with a logic analyzer, for each compiler - the boot
+/// calibration, if enabled, corrects them.
+static uint8_t _adjustments[ADJUSTMENT_COUNT] = {MAX_FLASH_PERIOD_ADJUSTMENT, MAX_BLANK_PERIOD_ADJUSTMENT,
+                                                 MAX_INTERVAL_PERIOD_ADJUSTMENT, SYNC_TIMER_DELAY_ADJUSTMENT};
+
+uint8_t get_timing_adjustment(uint8_t which) { return _adjustments[which]; }
+
+#ifdef ENABLE_CALIBRATION
+/// Free-running (simulation) timer counts, in usec, at each nOE edge of a
+/// calibration dry run: bright on, bright off, then on and off for each dim pulse.
+#define CALIBRATION_EDGE_COUNT (2 * (LED_LINE_LENGTH + 1))
+static uint16_t _calibration_edges[CALIBRATION_EDGE_COUNT];
+static uint8_t _calibration_edge_count = 0;
+static uint8_t _calibrating            = 0;
+
+/// Right after each nOE write, so the same cost lands in every measured period.
+#define CALIBRATION_EDGE()                                                                                             \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (_calibrating && _calibration_edge_count < CALIBRATION_EDGE_COUNT)                                              \
+    {                                                                                                                  \
+      FAST_TIM2_GET_COUNTER(_calibration_edges[_calibration_edge_count]);                                              \
+      _calibration_edge_count++;                                                                                       \
+    }                                                                                                                  \
+  } while (0)
+#else
+#define CALIBRATION_EDGE()                                                                                             \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#endif // ENABLE_CALIBRATION
+
+#ifdef ENABLE_BOOT_TIME
+/// TIM4 counts BOOT_TIME_TICK_US from the clock setup to the first flash
+/// process, its interrupt the overflows (every 2 ms, each costing the flash
+/// handlers and calibration under a usec). The boot code runs with interrupts
+/// masked up to the calibration, for well under 2 ms, so none is missed.
+static volatile uint8_t _boot_time_overflows = 0;
+/// 0 until reached, U16_MAX if past the 0.5 s the timer counts.
+static uint16_t _boot_ready_ticks                = 0;
+static volatile uint16_t _boot_first_flash_ticks = 0;
+
+static void boot_time_start()
+{
+  // Registers directly, as stm8s_tim4.c isn't part of the build.
+  TIM4->CR1  = 0;
+  TIM4->IER  = 0;
+  TIM4->CNTR = 0;
+  TIM4->PSCR = 0x07; // 2^7 = 128
+  TIM4->ARR  = U8_MAX;
+  // Load the buffered prescaler now rather than at the first overflow.
+  TIM4->EGR = TIM4_EGR_UG;
+  TIM4->SR1 = (uint8_t)~TIM4_SR1_UIF;
+  TIM4->IER = TIM4_IER_UIE;
+  TIM4->CR1 |= TIM4_CR1_CEN;
+}
+
+static void boot_time_stop()
+{
+  TIM4->IER = 0;
+  TIM4->CR1 &= (uint8_t)~TIM4_CR1_CEN;
+}
+
+/// Interrupts disabled, or from a handler.
+static uint16_t boot_time_now()
+{
+  uint8_t low  = TIM4->CNTR;
+  uint8_t high = _boot_time_overflows;
+  if (high == U8_MAX)
+    return U16_MAX;
+  // An overflow its handler hasn't counted yet.
+  if ((TIM4->SR1 & TIM4_SR1_UIF) && low < 0x80)
+    high++;
+  return ((uint16_t)high << 8) | low;
+}
+
+INTERRUPT_HANDLER(TIM4_UPD_OVF_IRQHandler, ITC_IRQ_TIM4_OVF)
+{
+  TIM4->SR1 = (uint8_t)~TIM4_SR1_UIF;
+  if (++_boot_time_overflows == U8_MAX)
+    boot_time_stop();
+}
+
+void get_boot_time(uint16_t *ready, uint16_t *first_flash)
+{
+  *ready = _boot_ready_ticks;
+  disableInterrupts();
+  *first_flash = _boot_first_flash_ticks;
+  enableInterrupts();
+}
+#endif // ENABLE_BOOT_TIME
 
 /// Set duration (starting from "start" or "sync signal" starting flash process)
 /// of initial (pattern-based) LED flash
 /// pulse. Essentially, the "bright" pulse duration.
 void set_flash_period(uint16_t period)
 {
-  _flash_period          = period;
-  _flash_period_as_timer = MAX_FLASH_PERIOD - (_flash_period - MAX_FLASH_PERIOD_ADJUSTMENT);
+  _flash_period  = period;
+  _config_staged = TRUE;
 }
 
 /// Set time from LEDs on to LEDs off between a pair of blanks. This is for the
@@ -225,41 +454,110 @@ void set_flash_period(uint16_t period)
 /// byte of LEDs off. Essentially, this is the "dim" duration.
 void set_blank_period(uint16_t period)
 {
-  _flash_blank_period          = period;
-  _flash_blank_period_as_timer = MAX_FLASH_PERIOD - (_flash_blank_period - MAX_BLANK_PERIOD_ADJUSTMENT);
+  _flash_blank_period = period;
+  _config_staged      = TRUE;
 }
 
 /// Set time between LEDs on during flash process.
 void set_interval_period(uint16_t period)
 {
-  _flash_interval_period          = period;
-  _flash_interval_period_as_timer = MAX_FLASH_PERIOD - (_flash_interval_period - MAX_INTERVAL_PERIOD_ADJUSTMENT);
+  _flash_interval_period = period;
+  _config_staged         = TRUE;
+}
+
+#ifdef ENABLE_MULTI_LEVEL
+/// Set duration of the level pulse lighting the level plane, after the pattern
+/// pulse - 0 leaves it out.
+void set_level_period(uint16_t period)
+{
+  _flash_level_period = period;
+  _config_staged      = TRUE;
+}
+#endif // ENABLE_MULTI_LEVEL
+
+/// Hands the periods (and adjustments) to the handlers - unlocked, so only with
+/// interrupts disabled.
+static void apply_config()
+{
+  _flash_period_as_timer          = MAX_FLASH_PERIOD - (_flash_period - _adjustments[ADJUSTMENT_FLASH]);
+  _flash_blank_period_as_timer    = MAX_FLASH_PERIOD - (_flash_blank_period - _adjustments[ADJUSTMENT_BLANK]);
+  _flash_interval_period_as_timer = MAX_FLASH_PERIOD - (_flash_interval_period - _adjustments[ADJUSTMENT_INTERVAL]);
+  _process_us                     = _flash_period + LED_LINE_LENGTH * (_flash_interval_period + _flash_blank_period);
+#ifdef ENABLE_MULTI_LEVEL
+  // Same handler path as the pattern pulse, so the same adjustment.
+  _flash_level_period_as_timer = 0;
+  if (_flash_level_period)
+  {
+    _flash_level_period_as_timer = MAX_FLASH_PERIOD - (_flash_level_period - _adjustments[ADJUSTMENT_FLASH]);
+    _process_us += _flash_interval_period + _flash_level_period;
+  }
+#endif
+  _config_staged = FALSE;
+}
+
+/// Main loop only: applies the periods if no process is running - otherwise they
+/// stay staged for the next commit event.
+static void commit_config()
+{
+  disableInterrupts();
+  if (PROC_STATE_NOW == STATE_PROCESS_AWAITING_START || PROC_STATE_NOW == STATE_AWAITING_PATTERN)
+  {
+    apply_config();
+  }
+  enableInterrupts();
 }
 
 uint16_t get_flash_period() { return _flash_period; }
 uint16_t get_blank_period() { return _flash_blank_period; }
 uint16_t get_interval_period() { return _flash_interval_period; }
+#ifdef ENABLE_MULTI_LEVEL
+uint16_t get_level_period() { return _flash_level_period; }
+#endif
 
 void actuallyStartFlashProcess();
 
+#ifdef ENABLE_SEQUENCER
+static uint8_t _seqPc   = 0;
+static uint8_t _seqLoop = 0;
+
+static void sequencer_run();
+#endif // ENABLE_SEQUENCER
+
 static inline void actuallyStartFlashProcess()
 {
+#ifdef ENABLE_SEQUENCER
+  // test pulse on T9 - with the sequencer, it spans the whole program.
+  FAST_GPIO_HIGH(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
+
+  // start process timer - the first timed step sets its counter.
+  FAST_TIM1_ENABLE();
+
+  _seqPc   = 0;
+  _seqLoop = 0;
+  sequencer_run();
+#else // ENABLE_SEQUENCER ^ / v fixed state machine
+
   // turn-on flash
-  GPIO_WriteLow(PORT_N_OE, PIN_N_OE);
+  FAST_GPIO_LOW(PORT_N_OE, PIN_N_OE);
+  CALIBRATION_EDGE();
   // GPIO_WriteLow( GPIOD, PIN_TESTPOINT_10 );
 
   // process timer restart
-  TIM1_SetCounter(_flash_period_as_timer);
+  FAST_TIM1_SET_COUNTER(_flash_period_as_timer);
 
   // start process timer
-  TIM1_Cmd(ENABLE);
+  FAST_TIM1_ENABLE();
 
   // test pulse on T9
-  GPIO_WriteHigh(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
+  FAST_GPIO_HIGH(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
 
   // start blank sequence
   _subState  = 0;
   _procState = STATE_PATTERN_ON;
+#endif // ENABLE_SEQUENCER
+
+  PERF_COUNT(PERF_FRAMES_FLASHED);
+  TRACE(TRACE_FLASH_START, _latched_index);
 }
 
 void enable_sync_interrupt();
@@ -283,12 +581,63 @@ static inline void disable_sync_interrupt()
   PORT_CAMERA_SYNC->CR2 &= ~((uint8_t)PIN_CAMERA_SYNC);
 }
 
+#ifdef ENABLE_SIMULATION
+static uint8_t _simulation_in_process = 0;
+#endif
+
+/// Flash on every _sync_divider-th camera sync: the syncs still to skip before
+/// the next one flashed.
+static uint8_t _sync_divider  = 1;
+static uint8_t _syncs_to_skip = 0;
+
+#ifdef ENABLE_SIMULATION
+/// Simulation timer ticks between the last two syncs - 0 if it ran out (and
+/// simulated one) in between.
+static volatile uint16_t _sync_period_ticks = 0;
+#endif
+
+#ifdef ENABLE_SYNC_MULTIPLIER
+/// Flash processes per camera sync, and those still due for the current one.
+static uint8_t _sync_multiplier = 1;
+static uint8_t _multiples_left  = 0;
+/// From the last dim pulse off to the next process's bright pulse.
+static uint16_t _multiple_wait_as_timer;
+#endif
+
+static void post_phase_report()
+{
+#ifdef PHASE_REPORT_IN_USE
+  _phaseReport = PHASE_REPORT_FLAG | _latched_index;
+#ifdef ENABLE_SIMULATION
+  if (_simulation_in_process)
+    _phaseReport |= PHASE_REPORT_SIMULATED;
+#endif
+#endif // PHASE_REPORT_IN_USE
+}
+
 // can be called from anywhere - it just starts flash process
 static void flash_process_start()
 {
-  // disable external interrupt
+#ifdef ENABLE_BOOT_TIME
+  // Not the calibration's dry runs, before the boot is done.
+  if (_boot_ready_ticks && !_boot_first_flash_ticks)
+  {
+    _boot_first_flash_ticks = boot_time_now();
+    boot_time_stop();
+  }
+#endif
+
+  if (UPLOAD_PENDING())
+  {
+    // The main loop hasn't uploaded the next pattern yet: the previous one shows again.
+    PERF_COUNT(PERF_LATE_PATTERNS);
+  }
+
+  // disable external interrupt - unless dividing, which has to hear every sync
+  // to count them.
   // GPIO_Init(PORT_CAMERA_SYNC, PIN_CAMERA_SYNC, GPIO_MODE_IN_FL_NO_IT);
-  disable_sync_interrupt();
+  if (_sync_divider == 1)
+    disable_sync_interrupt();
 
 // Wait a bit before starting the flash process to account for sync mistiming.
 
@@ -296,10 +645,10 @@ static void flash_process_start()
 #ifdef SYNC_DELAY_TIMER
   _procState = STATE_IN_STARTUP_DELAY;
   // Set timer for delay duration.
-  TIM1_SetCounter(MAX_FLASH_PERIOD - (SYNC_DELAY_TOTAL_US - SYNC_TIMER_DELAY_ADJUSTMENT));
+  FAST_TIM1_SET_COUNTER(MAX_FLASH_PERIOD - (SYNC_DELAY_TOTAL_US - _adjustments[ADJUSTMENT_SYNC_DELAY]));
 
   // start process timer
-  TIM1_Cmd(ENABLE);
+  FAST_TIM1_ENABLE();
 
 #else // SYNC_DELAY_TIMER ^ / v sync delay via loops
 
@@ -321,7 +670,37 @@ static void flash_process_start()
   actuallyStartFlashProcess();
 
 #endif
+
+  // After the timer is running, so as not to shift the flash.
+  post_phase_report();
+}
+
+#ifdef ENABLE_SYNC_MULTIPLIER
+/// Right after a sync's first process starts: plans the multiplier's others,
+/// spaced evenly over the sync period measured - or drops them if they no
+/// longer fit it.
+static void schedule_multiples()
+{
+  uint16_t spacing = 0;
+  _multiples_left  = 0;
+  if (_sync_multiplier == 1)
+    return;
+
+  if (_sync_period_ticks && _sync_period_ticks <= SYNC_PERIOD_MAX_TICKS)
+  {
+    uint16_t period_us = _sync_period_ticks * SYNC_PERIOD_TICK_US;
+    if (sync_rate_fits(period_us, _sync_divider, _sync_multiplier, _process_us))
+      spacing = sync_rate_spacing(period_us, _sync_multiplier, _process_us);
+  }
+  if (!spacing)
+  {
+    PERF_COUNT(PERF_DROPPED_MULTIPLES);
+    return;
+  }
+  _multiples_left         = _sync_multiplier - 1;
+  _multiple_wait_as_timer = MAX_FLASH_PERIOD - (spacing - _process_us - _adjustments[ADJUSTMENT_INTERVAL]);
 }
+#endif // ENABLE_SYNC_MULTIPLIER
 
 // INT     -______________________
 // FLASH   _---_--_--_--_--_--____
@@ -331,29 +710,124 @@ static void finishLEDProcess()
 {
 
   // Disable this timer
-  TIM1_Cmd(DISABLE);
+  FAST_TIM1_DISABLE();
 
   // Next time timer is enabled, use flash period as counter.
-  TIM1_SetCounter(_flash_period_as_timer);
+  FAST_TIM1_SET_COUNTER(_flash_period_as_timer);
 
   // enable external interrupt on sync pin (floating)
   // GPIO_Init(PORT_CAMERA_SYNC, PIN_CAMERA_SYNC, GPIO_MODE_IN_FL_IT);
   enable_sync_interrupt();
 
-  // allow new pattern to be written to LEDs
+  // allow new pattern to be written to LEDs - after any settings changed during
+  // the process, so the next process starts with them.
   _procState = STATE_AWAITING_PATTERN;
   _subState  = 0;
+  event_queue_push(EVENT_COMMIT_CONFIG, 0);
+#ifdef ENABLE_SIMULATION
+  request_upload(EVENT_UPLOAD_PATTERN, _simulation_in_process);
+#else
+  request_upload(EVENT_UPLOAD_PATTERN, 0);
+#endif
+}
+
+#ifdef ENABLE_SEQUENCER
+/// Runs program steps up to and including the next timed one, which leaves the
+/// process timer armed for its duration. Finishes the process at the end.
+///
+/// Cost from the interrupt to the nOE edge against the fixed state machine's
+/// switch, estimated from the STM8 instruction timings in cycles of the 16MHz
+/// clock (switch -> sequencer):
+///
+/// - dispatch: ~8 (compare chain on _procState) -> ~18 (index seq_program by
+///   _seqPc, then the compare chain on op)
+/// - upload: none ahead of the edge (the switch requests it after) -> ~60,
+///   its fetch and dispatch and the request_upload() call
+/// - loop: none (the switch counts _subState within its states) -> ~30 with its
+///   fetch and dispatch
+///
+/// Pulse and wait steps set the counter precomputed by sequencer_prepare(), as
+/// the switch does. So a timed step's edge comes ~1 usec later than the
+/// switch's, ~4 usec more after an upload and ~2 more after a loop:
+/// SEQUENCER_STEP_OVERHEAD and the others in MCUConfig.h, which
+/// sequencer_prepare() takes off the step before.
+static void sequencer_run()
+{
+  while (_seqPc < SEQ_MAX_STEPS)
+  {
+    SeqStep *step = &seq_program[_seqPc++];
+    switch (step->op)
+    {
+    case SEQ_OP_PULSE:
+      if (_procState == STATE_BETWEEN_PULSES && UPLOAD_PENDING())
+      {
+// shouldn't get here!
+// it means we couldn't get around to uploading the frame before the timer
+// went off
+        PERF_COUNT(PERF_MISSED_UPLOADS);
+#ifndef PRODUCTION
+        assert_param(!UPLOAD_PENDING());
+#endif
+        // Wait some more, then retry this step.
+        _seqPc--;
+        FAST_TIM1_SET_COUNTER(_flash_interval_period_as_timer);
+        return;
+      }
+      // turn on flash
+      FAST_GPIO_LOW(PORT_N_OE, PIN_N_OE);
+      _procState = STATE_PATTERN_ON;
+      FAST_TIM1_SET_COUNTER(seq_timer[_seqPc - 1]);
+      return;
+    case SEQ_OP_WAIT:
+      // turn off flash
+      FAST_GPIO_HIGH(PORT_N_OE, PIN_N_OE);
+      FAST_TIM1_SET_COUNTER(seq_timer[_seqPc - 1]);
+      return;
+    case SEQ_OP_UPLOAD:
+      _procState = STATE_BETWEEN_PULSES;
+      request_upload(EVENT_UPLOAD_FRAME,
+                     step->arg == SEQ_FRAME_LOOP_GROUP ? (SEQ_FRAME_GROUP | (_seqLoop & 0x3F)) : step->arg);
+      break;
+    case SEQ_OP_LOOP:
+      if (++_seqLoop < step->duration)
+      {
+        _seqPc = step->arg;
+      }
+      else
+      {
+        _seqLoop = 0;
+      }
+      break;
+    default: // SEQ_OP_END
+      _seqPc = SEQ_MAX_STEPS;
+      break;
+    }
+  }
+
+  FAST_GPIO_HIGH(PORT_N_OE, PIN_N_OE);
+  FAST_GPIO_LOW(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
+  finishLEDProcess();
 }
+#endif // ENABLE_SEQUENCER
 // called by hardware timer (process timer)
 INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, ITC_IRQ_TIM1_OVF)
 {
   // Pull test point high to signal entry into the process timer interrupt
   // handler.
-  GPIO_WriteHigh(PORT_TESTPOINT_10, PIN_TESTPOINT_10);
+  FAST_GPIO_HIGH(PORT_TESTPOINT_10, PIN_TESTPOINT_10);
 
   // Disable this timer to avoid counting while we set it.
   // TIM1_Cmd(DISABLE);
 
+#ifdef ENABLE_SEQUENCER
+#if defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
+  if (_procState == STATE_IN_STARTUP_DELAY)
+    actuallyStartFlashProcess();
+  else
+#endif // defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
+    sequencer_run();
+  TRACE(TRACE_PROCESS_TIMER, _seqPc);
+#else  // ENABLE_SEQUENCER ^ / v fixed state machine
   switch (_procState)
   {
 #if defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
@@ -363,7 +837,24 @@ INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, ITC_IRQ_TIM1_OVF)
 #endif // defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
   case STATE_PATTERN_ON:
     // end test pulse on T9
-    GPIO_WriteLow(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
+    FAST_GPIO_LOW(PORT_TESTPOINT_9, PIN_TESTPOINT_9);
+#ifdef ENABLE_MULTI_LEVEL
+    if (_flash_level_period_as_timer)
+    {
+      // The level pulse comes first, lighting the level plane row.
+      FAST_GPIO_HIGH(PORT_N_OE, PIN_N_OE);
+      _procState = STATE_BEFORE_LEVEL_PULSE;
+      FAST_TIM1_SET_COUNTER(_flash_interval_period_as_timer);
+#ifdef ENABLE_SIMULATION
+      request_upload(EVENT_UPLOAD_LEVEL, _simulation_in_process);
+#else
+      request_upload(EVENT_UPLOAD_LEVEL, 0);
+#endif
+      break;
+    }
+  /// otherwise fall through, as after the level pulse.
+  case STATE_LEVEL_PULSE_ON:
+#endif // ENABLE_MULTI_LEVEL
   /// then fall through to turn off the flash, prepare for upload, etc.
   case STATE_DIM_PULSE_ON:
   {
@@ -371,19 +862,37 @@ INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, ITC_IRQ_TIM1_OVF)
     /// If starting from a dim state, we increment the sub state first.
     uint8_t nextSubState = _procState == STATE_DIM_PULSE_ON ? _subState + 1 : _subState;
     // turn off flash
-    GPIO_WriteHigh(PORT_N_OE, PIN_N_OE);
+    FAST_GPIO_HIGH(PORT_N_OE, PIN_N_OE);
+    CALIBRATION_EDGE();
     if (nextSubState < LED_LINE_LENGTH)
     {
       _subState  = nextSubState;
-      _procState = STATE_BETWEEN_PULSES_AWAITING_BLANK_UPLOAD;
-      TIM1_SetCounter(_flash_interval_period_as_timer);
+      _procState = STATE_BETWEEN_PULSES;
+      FAST_TIM1_SET_COUNTER(_flash_interval_period_as_timer);
+      request_upload(EVENT_UPLOAD_BLANK, nextSubState);
     }
+#ifdef ENABLE_SYNC_MULTIPLIER
+    else if (_multiples_left)
+    {
+      // Another process for this sync, no lockout in between: the main loop
+      // uploads its pattern while we wait out the spacing.
+      _multiples_left--;
+      _subState  = 0;
+      _procState = STATE_BETWEEN_MULTIPLES;
+      FAST_TIM1_SET_COUNTER(_multiple_wait_as_timer);
+      request_upload(EVENT_UPLOAD_PATTERN, 0);
+    }
+#endif // ENABLE_SYNC_MULTIPLIER
     else
     {
       // OK, we've done all the sub-states, now we just lock out of sync for a
       // while before finally exiting.
       _procState = STATE_POST_PROCESS_LOCKOUT;
-      TIM1_SetCounter(MAX_FLASH_PERIOD - FLASH_SYNC_LOCKOUT_PERIOD);
+      FAST_TIM1_SET_COUNTER(MAX_FLASH_PERIOD - FLASH_SYNC_LOCKOUT_PERIOD);
+#ifdef ENABLE_PERF_COUNTERS
+      // Listen during the lockout just to count (and reject) syncs.
+      enable_sync_interrupt();
+#endif
     }
   }
   break;
@@ -393,27 +902,55 @@ INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, ITC_IRQ_TIM1_OVF)
     // interrupts, etc.
     finishLEDProcess();
     break;
-  case STATE_BETWEEN_PULSES_AWAITING_BLANK_UPLOAD:
+#ifdef ENABLE_MULTI_LEVEL
+  case STATE_BEFORE_LEVEL_PULSE:
+#endif
+  case STATE_BETWEEN_PULSES:
+    if (UPLOAD_PENDING())
+    {
 // shouldn't get here!
 // it means we couldn't get around to uploading the pattern before the timer
 // went off
+      PERF_COUNT(PERF_MISSED_UPLOADS);
 #ifndef PRODUCTION
-    assert_param(_procState != STATE_BETWEEN_PULSES_AWAITING_BLANK_UPLOAD);
+      assert_param(!UPLOAD_PENDING());
 #else
-    // Wait some more.
-    TIM1_SetCounter(_flash_interval_period_as_timer);
+      // Wait some more.
+      FAST_TIM1_SET_COUNTER(_flash_interval_period_as_timer);
 #endif
-    break;
-  case STATE_BETWEEN_PULSES_AWAITING_TIMER:
+      break;
+    }
     // turn on flash
-    GPIO_WriteLow(PORT_N_OE, PIN_N_OE);
-    TIM1_SetCounter(_flash_blank_period_as_timer);
+    FAST_GPIO_LOW(PORT_N_OE, PIN_N_OE);
+    CALIBRATION_EDGE();
+#ifdef ENABLE_MULTI_LEVEL
+    if (_procState == STATE_BEFORE_LEVEL_PULSE)
+    {
+      FAST_TIM1_SET_COUNTER(_flash_level_period_as_timer);
+      _procState = STATE_LEVEL_PULSE_ON;
+      break;
+    }
+#endif
+    FAST_TIM1_SET_COUNTER(_flash_blank_period_as_timer);
     _procState = STATE_DIM_PULSE_ON;
     break;
+#ifdef ENABLE_SYNC_MULTIPLIER
+  case STATE_BETWEEN_MULTIPLES:
+    if (UPLOAD_PENDING())
+    {
+      // As at a sync: the previous pattern shows again.
+      PERF_COUNT(PERF_LATE_PATTERNS);
+    }
+    actuallyStartFlashProcess();
+    post_phase_report();
+    break;
+#endif // ENABLE_SYNC_MULTIPLIER
   }
+  TRACE(TRACE_PROCESS_TIMER, _procState);
+#endif // ENABLE_SEQUENCER
 
   // Clear Interrupt Pending bit since we handled it.
-  TIM1_ClearITPendingBit(TIM1_IT_UPDATE);
+  FAST_TIM1_CLEAR_UPDATE();
 #if 0
   if (_procState != STATE_AWAITING_PATTERN)
   {
@@ -424,40 +961,67 @@ INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, ITC_IRQ_TIM1_OVF)
 
   // Bring test point low to signal completion of the process timer interrupt
   // handler.
-  GPIO_WriteLow(PORT_TESTPOINT_10, PIN_TESTPOINT_10);
+  FAST_GPIO_LOW(PORT_TESTPOINT_10, PIN_TESTPOINT_10);
 }
 
 static uint8_t _simulation_period;
 
 #ifdef ENABLE_SIMULATION
 
-static uint8_t _simulation_in_process = 0;
 // called by hardware timer (simulated sync signal)
 INTERRUPT_HANDLER(TIM2_UPD_OVF_BRK_IRQHandler, ITC_IRQ_TIM2_OVF)
 {
   // test point output
-  GPIO_WriteReverse(PORT_TESTPOINT_8, PIN_TESTPOINT_8);
+  FAST_GPIO_TOGGLE(PORT_TESTPOINT_8, PIN_TESTPOINT_8);
 
   // Cleat Interrupt Pending bit
-  TIM2_ClearITPendingBit(TIM2_IT_UPDATE);
+  FAST_TIM2_CLEAR_UPDATE();
 
   _simulation_in_process = 1;
 
   // start flash by simualtion (comment it out to stop simulation)
   flash_process_start();
+
+  PERF_COUNT(PERF_SIMULATED_SYNCS);
+  TRACE(TRACE_SYNC, 1);
 }
 
 #endif // ENABLE_SIMULATION
 
-#ifdef SYNC_INTERVAL
-uint8_t gotSync = 0;
-#endif
-
 // called by sync signal
 INTERRUPT_HANDLER(TLI_IRQHandler, CAMERA_SYNC_IRQ_VECTOR)
 {
   // test point output
-  GPIO_WriteReverse(PORT_TESTPOINT_7, PIN_TESTPOINT_7);
+  FAST_GPIO_TOGGLE(PORT_TESTPOINT_7, PIN_TESTPOINT_7);
+
+  if (_procState != STATE_PROCESS_AWAITING_START && _procState != STATE_AWAITING_PATTERN && !_syncs_to_skip)
+  {
+    // Only listening in the lockout to count these (with the perf counters) -
+    // not a sync to time from, so leave the simulation timer and period alone.
+    PERF_COUNT(PERF_LOCKOUT_SYNCS);
+    TRACE(TRACE_LOCKOUT_SYNC, 0);
+    return;
+  }
+
+#ifdef ENABLE_SIMULATION
+  // The simulation timer restarts at every sync, so it's measured the period -
+  // unless it ran out and simulated one.
+  if (_simulation_in_process)
+    _sync_period_ticks = 0;
+  else
+    FAST_TIM2_GET_COUNTER(_sync_period_ticks);
+
+  // simulation timer restart
+  FAST_TIM2_RESET_COUNTER();
+#endif // ENABLE_SIMULATION
+
+  if (_procState != STATE_PROCESS_AWAITING_START && _procState != STATE_AWAITING_PATTERN)
+  {
+    // A real sync the divider skips mid-process: it still marks the period, but
+    // finishLEDProcess re-enables sync for the next process.
+    _syncs_to_skip--;
+    return;
+  }
 
 #ifdef WAIT_FOR_RISE
   while (RESET == GPIO_ReadInputPin(PORT_CAMERA_SYNC, PIN_CAMERA_SYNC))
@@ -467,29 +1031,61 @@ INTERRUPT_HANDLER(TLI_IRQHandler, CAMERA_SYNC_IRQ_VECTOR)
 #endif
 
 #ifdef ENABLE_SIMULATION
-  // simulation timer restart
-  TIM2_SetCounter(0);
-
   _simulation_in_process = 0;
 #endif // ENABLE_SIMULATION
 
-#ifdef SYNC_INTERVAL
-  // For debugging, only start up the flash every SYNC_INTERVAL pulses
-  if (gotSync == (SYNC_INTERVAL - 1))
+  if (_syncs_to_skip)
   {
-    gotSync = 0;
+    _syncs_to_skip--;
+  }
+  else
+  {
+    _syncs_to_skip = _sync_divider - 1;
     // start flash by sync
     flash_process_start();
+#ifdef ENABLE_SYNC_MULTIPLIER
+    schedule_multiples();
+#endif
   }
-  else
+
+  PERF_COUNT(PERF_SYNCS);
+  TRACE(TRACE_SYNC, 0);
+}
+
+#ifdef ENABLE_UART
+/// Received bytes, from the receive interrupt to the main loop - free-running
+/// indices with a single writer each, like the event queue.
+#define UART_RX_DEPTH 8
+#define UART_RX_DEPTH_MASK (UART_RX_DEPTH - 1)
+static NEAR volatile uint8_t _rxBytes[UART_RX_DEPTH];
+static volatile uint8_t _rxWrite = 0;
+static volatile uint8_t _rxRead  = 0;
+
+/// At the lowest priority, so the flash process handlers can interrupt it - and
+/// it touches nothing they do.
+INTERRUPT_HANDLER(UART1_RX_IRQHandler, ITC_IRQ_UART1_RX)
+{
+  // Reading the data register clears the flag.
+  uint8_t ch    = UART1->DR;
+  uint8_t write = _rxWrite;
+  if ((uint8_t)(write - _rxRead) == UART_RX_DEPTH)
   {
-    gotSync++;
+    PERF_COUNT(PERF_UART_OVERRUNS);
+    return;
   }
-#else
-  // start flash by sync
-  flash_process_start();
-#endif
+  _rxBytes[write & UART_RX_DEPTH_MASK] = ch;
+  _rxWrite                             = write + 1;
+}
+
+#ifdef ENABLE_WAIT_FOR_INTERRUPT
+/// Only there to wake the main loop when the transmitter can take another byte:
+/// the main loop sends it, and re-arms this if there's more.
+INTERRUPT_HANDLER(UART1_TX_IRQHandler, ITC_IRQ_UART1_TX)
+{
+  UART1->CR2 &= (uint8_t)~UART1_CR2_TIEN;
 }
+#endif // ENABLE_WAIT_FOR_INTERRUPT
+#endif // ENABLE_UART
 
 static void set_flash_timer_max_period(uint16_t flash_time_us)
 {
@@ -508,6 +1104,112 @@ static void set_flash_timer_max_period(uint16_t flash_time_us)
   enableInterrupts();
 }
 
+#ifdef ENABLE_CALIBRATION
+/// Dry runs of the flash process per calibration.
+#define CALIBRATION_RUNS 4
+
+/// Any more and something other than handler overhead got measured (a sync
+/// arriving mid-run, say): keep the compile-time value.
+#define CALIBRATION_MAX_ADJUSTMENT 40
+
+/// Adds how much longer than intended a period ran to an error sum.
+static void calibration_add_error(int16_t *sum, uint16_t from, uint16_t to, uint16_t intended)
+{
+  *sum += (int16_t)(uint16_t)(to - from) - (int16_t)intended;
+}
+
+/// A period that ran long needs a bigger adjustment: correct by the (rounded)
+/// mean error.
+static void calibration_correct(uint8_t which, int16_t sum, uint8_t count)
+{
+  int16_t half       = sum < 0 ? -(int16_t)(count / 2) : (int16_t)(count / 2);
+  int16_t adjustment = (int16_t)_adjustments[which] + (sum + half) / (int16_t)count;
+  if (adjustment >= 0 && adjustment <= CALIBRATION_MAX_ADJUSTMENT)
+    _adjustments[which] = (uint8_t)adjustment;
+}
+
+/// Times dry runs of the flash process, with LED power off, against the
+/// simulation timer free-running at 1MHz, and corrects each adjustment by the
+/// mean error of the periods it applies to. The sync delay is timed from the
+/// call to flash_process_start, so the sync interrupt entry and the handler's
+/// code before that call are only covered by the compile-time value.
+static void calibrate_timing()
+{
+  int16_t flashError = 0, blankError = 0, intervalError = 0, syncDelayError = 0;
+  uint8_t runs = 0, run, i;
+  Event event;
+
+  GPIO_WriteLow(PORT_LED_PWR_EN, PIN_LED_PWR_EN);
+  TIM2_TimeBaseInit(TIM2_PRESCALER_16, U16_MAX);
+  TIM2_Cmd(ENABLE);
+
+  for (run = 0; run < CALIBRATION_RUNS; run++)
+  {
+    _calibration_edge_count = 0;
+    _calibrating            = 1;
+
+    // As if from the sync interrupt.
+    disableInterrupts();
+    uint16_t start;
+    FAST_TIM2_GET_COUNTER(start);
+    flash_process_start();
+    enableInterrupts();
+
+    // Stand in for the main loop, without uploading anything, until the process
+    // asks for the next pattern.
+    event.type = EVENT_COMMIT_CONFIG;
+    while (event.type != EVENT_UPLOAD_PATTERN)
+    {
+      if (event_queue_pop(&event) && event.type != EVENT_COMMIT_CONFIG)
+        _uploadsDone++;
+    }
+    _calibrating = 0;
+    disable_sync_interrupt();
+
+    if (_calibration_edge_count != CALIBRATION_EDGE_COUNT)
+      continue;
+
+    calibration_add_error(&flashError, _calibration_edges[0], _calibration_edges[1], _flash_period);
+    for (i = 1; i <= LED_LINE_LENGTH; i++)
+    {
+      calibration_add_error(&intervalError, _calibration_edges[2 * i - 1], _calibration_edges[2 * i],
+                            _flash_interval_period);
+      calibration_add_error(&blankError, _calibration_edges[2 * i], _calibration_edges[2 * i + 1], _flash_blank_period);
+    }
+#if defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
+    calibration_add_error(&syncDelayError, start, _calibration_edges[0], SYNC_DELAY_TOTAL_US);
+#endif
+    runs++;
+  }
+
+  if (runs > 0)
+  {
+    calibration_correct(ADJUSTMENT_FLASH, flashError, runs);
+    calibration_correct(ADJUSTMENT_BLANK, blankError, runs * LED_LINE_LENGTH);
+    calibration_correct(ADJUSTMENT_INTERVAL, intervalError, runs * LED_LINE_LENGTH);
+#if defined(SYNC_DELAY_TOTAL_US) && defined(SYNC_DELAY_TIMER)
+    calibration_correct(ADJUSTMENT_SYNC_DELAY, syncDelayError, runs);
+#endif
+  }
+
+  // Re-apply the periods with the new adjustments.
+  commit_config();
+
+  TIM2_Cmd(DISABLE);
+  TIM2_DeInit();
+  GPIO_WriteHigh(PORT_LED_PWR_EN, PIN_LED_PWR_EN);
+
+  // Forget the dry runs.
+#ifdef PHASE_REPORT_IN_USE
+  _phaseReport = 0;
+#endif
+#ifdef ENABLE_PERF_COUNTERS
+  perf_counters_reset();
+#endif
+  enable_sync_interrupt();
+}
+#endif // ENABLE_CALIBRATION
+
 void set_interval_simulator(uint8_t simulation_period_time_ms)
 {
 #ifdef ENABLE_SIMULATION
@@ -530,6 +1232,72 @@ void set_interval_simulator(uint8_t simulation_period_time_ms)
 
 uint8_t get_simulation_period() { return _simulation_period; }
 
+uint8_t set_sync_rate(uint8_t divider, uint8_t multiplier)
+{
+  uint16_t period_us = get_sync_period();
+  if ((divider > 1 || multiplier > 1) && period_us && !sync_rate_fits(period_us, divider, multiplier, _process_us))
+  {
+    return FALSE;
+  }
+
+  disableInterrupts();
+  _sync_divider = divider;
+  if (_syncs_to_skip >= divider)
+    _syncs_to_skip = divider - 1;
+#ifdef ENABLE_SYNC_MULTIPLIER
+  _sync_multiplier = multiplier;
+#endif
+  enableInterrupts();
+  return TRUE;
+}
+
+uint8_t get_sync_divider() { return _sync_divider; }
+
+uint8_t get_sync_multiplier()
+{
+#ifdef ENABLE_SYNC_MULTIPLIER
+  return _sync_multiplier;
+#else
+  return 1;
+#endif
+}
+
+uint16_t get_sync_period()
+{
+#ifdef ENABLE_SIMULATION
+  uint16_t ticks;
+  disableInterrupts();
+  ticks = _sync_period_ticks;
+  enableInterrupts();
+  return ticks <= SYNC_PERIOD_MAX_TICKS ? ticks * SYNC_PERIOD_TICK_US : 0;
+#else
+  return 0;
+#endif
+}
+
+uint8_t get_pattern_index() { return index_16; }
+
+#ifdef ENABLE_WAIT_FOR_INTERRUPT
+/// Call with interrupts disabled. Arms the transmit interrupt if there's output
+/// waiting, so the sleep ends when it can be sent.
+static uint8_t main_loop_is_idle()
+{
+  if (!event_queue_is_empty())
+    return FALSE;
+#ifdef PHASE_REPORT_IN_USE
+  if (_phaseReport)
+    return FALSE;
+#endif
+#ifdef ENABLE_UART
+  if (_rxRead != _rxWrite || protocol_has_work())
+    return FALSE;
+  if (protocol_is_output_ready())
+    UART1->CR2 |= UART1_CR2_TIEN;
+#endif
+  return TRUE;
+}
+#endif // ENABLE_WAIT_FOR_INTERRUPT
+
 extern const char BUILD_DESC[];
 
 #if defined(OSVR_IR_IAR_STM8)
@@ -552,10 +1320,14 @@ void main(void)
   CLK->SWR = 0xB4;
   CLK_CCOCmd(ENABLE);
 
+#ifdef ENABLE_BOOT_TIME
+  boot_time_start();
+#endif
+
   GPIO_Init(PORT_LED_PWR_EN, PIN_LED_PWR_EN, GPIO_MODE_OUT_PP_HIGH_SLOW); // PB0: IR_LED_PWR_EN active high
 
 #ifdef ENABLE_UART
-  UART1_Init(115200, UART1_WORDLENGTH_8D, UART1_STOPBITS_1, UART1_PARITY_NO, UART1_SYNCMODE_CLOCK_DISABLE,
+  UART1_Init(UART_BAUD_RATE, UART1_WORDLENGTH_8D, UART1_STOPBITS_1, UART1_PARITY_NO, UART1_SYNCMODE_CLOCK_DISABLE,
              UART1_MODE_TXRX_ENABLE); // UART1 init
 #endif
 
@@ -581,6 +1353,12 @@ void main(void)
   GPIO_Init(PORT_TESTPOINT_8, PIN_TESTPOINT_8, GPIO_MODE_OUT_PP_LOW_SLOW);
   GPIO_Init(PORT_TESTPOINT_9, PIN_TESTPOINT_9, GPIO_MODE_OUT_PP_LOW_SLOW);
   GPIO_Init(PORT_TESTPOINT_10, PIN_TESTPOINT_10, GPIO_MODE_OUT_PP_HIGH_SLOW);
+#ifdef ENABLE_PHASE_PULSE_CODE
+  GPIO_Init(PORT_PHASE_CODE, PIN_PHASE_CODE, GPIO_MODE_OUT_PP_LOW_FAST);
+#endif
+#if defined(ENABLE_SELF_TEST) && defined(PORT_SELF_TEST_STRAP)
+  GPIO_Init(PORT_SELF_TEST_STRAP, PIN_SELF_TEST_STRAP, GPIO_MODE_IN_PU_NO_IT);
+#endif
 
   // Init external IRQ
   GPIO_Init(PORT_CAMERA_SYNC, PIN_CAMERA_SYNC, GPIO_MODE_IN_FL_IT);
@@ -608,55 +1386,210 @@ void main(void)
 
 #ifdef ENABLE_UART
   protocol_init();
+  UART1_ITConfig(UART1_IT_RXNE_OR, ENABLE);
+  ITC_SetSoftwarePriority(ITC_IRQ_UART1_RX, ITC_PRIORITYLEVEL_1);
+#ifdef ENABLE_WAIT_FOR_INTERRUPT
+  ITC_SetSoftwarePriority(ITC_IRQ_UART1_TX, ITC_PRIORITYLEVEL_1);
+#endif
+#endif
+
+  event_queue_init();
+
+#ifdef ENABLE_FRAME_STREAM
+  frame_stream_init();
 #endif
 
-  default_array_init();
+#ifdef ENABLE_SEQUENCER
+  sequencer_init();
+#endif
+
+#if defined(ENABLE_SELF_TEST) && defined(PORT_SELF_TEST_STRAP)
+  // Read well after enabling the pull-up, so the pin has settled.
+  if (GPIO_ReadInputPin(PORT_SELF_TEST_STRAP, PIN_SELF_TEST_STRAP) == RESET)
+    self_test_start(SELF_TEST_FRAMES_PER_STEP);
+#endif
+
+  // Falls back to the compiled-in default if the EEPROM holds an out-of-range bank.
+  if (!bank_array_init(settings_boot_pattern_bank, settings_boot_mask_bank))
+  {
+    default_array_init();
+  }
+  device_array_init(settings_device_id);
 
   set_flash_period(FLASH_BRIGHT_PERIOD);
   set_blank_period(FLASH_DIM_PERIOD);
   set_interval_period(FLASH_INTERVAL_PERIOD);
+  apply_config();
 
   set_flash_timer_max_period(MAX_FLASH_PERIOD);
+#ifdef ENABLE_CALIBRATION
+  calibrate_timing();
+#endif
+#ifdef ENABLE_MULTI_LEVEL
+  // After the calibration, whose dry runs time the pattern and dim pulses alone.
+  set_level_period(FLASH_LEVEL_PERIOD);
+  apply_config();
+#endif
   TIM1_SetCounter(_flash_period_as_timer);
 
   set_interval_simulator(SIMULATION_PERIOD);
 
   index_16 = 0;
 
+#ifdef ENABLE_BOOT_TIME
+  disableInterrupts();
+  _boot_ready_ticks = boot_time_now();
+#endif
+
   // enable interrupts
   enableInterrupts();
 
   while (1)
   {
-    switch (_procState)
+    Event event;
+    if (event_queue_pop(&event))
     {
-    case STATE_BETWEEN_PULSES_AWAITING_BLANK_UPLOAD:
-      Send_blanks_spi_data();
-      _procState = STATE_BETWEEN_PULSES_AWAITING_TIMER;
-      break;
-    case STATE_AWAITING_PATTERN:
+      switch (event.type)
+      {
+      case EVENT_UPLOAD_BLANK:
+        TRACE_FROM_MAIN(TRACE_UPLOAD_START, TRACE_UPLOAD_GROUP | event.arg);
+#ifdef ENABLE_SELF_TEST
+        if (self_test_frames_per_step())
+          Send_self_test_spi_data(event.arg);
+        else
+#endif
+          Send_blanks_spi_data(event.arg);
+        TRACE_FROM_MAIN(TRACE_UPLOAD_END, TRACE_UPLOAD_GROUP | event.arg);
+        _uploadsDone++;
+        break;
+#ifdef ENABLE_SEQUENCER
+      case EVENT_UPLOAD_FRAME:
+        // SEQ_FRAME_GROUP matches TRACE_UPLOAD_GROUP
+        TRACE_FROM_MAIN(TRACE_UPLOAD_START, event.arg == SEQ_FRAME_CURRENT_ROW ? _latched_index : event.arg);
+        if (SEQ_FRAME_IS_GROUP(event.arg))
+        {
+#ifdef ENABLE_SELF_TEST
+          if (self_test_frames_per_step())
+            Send_self_test_spi_data(SEQ_FRAME_GROUP_NUMBER(event.arg));
+          else
+#endif
+            Send_blanks_spi_data(SEQ_FRAME_GROUP_NUMBER(event.arg));
+        }
+#ifdef ENABLE_SELF_TEST
+        else if (self_test_frames_per_step())
+          Send_self_test_spi_data(SELF_TEST_BRIGHT);
+#endif
+        else if (event.arg == SEQ_FRAME_CURRENT_ROW)
+          Send_driver_data(active_driver_frames[_latched_index]);
+        else
+          Send_driver_data(active_driver_frames[event.arg]);
+        TRACE_FROM_MAIN(TRACE_UPLOAD_END, event.arg == SEQ_FRAME_CURRENT_ROW ? _latched_index : event.arg);
+        _uploadsDone++;
+        break;
+#endif // ENABLE_SEQUENCER
+      case EVENT_UPLOAD_PATTERN:
+        // The device's phase keeps its codes apart from other devices'.
+        _latched_index = (index_16 + pattern_phase) & 0x0F;
 // Move to the next value in the patterns
+#ifdef ENABLE_SELF_TEST
+        // The self-test runs off simulated syncs too, so it can be checked by eye.
+        if (self_test_frames_per_step())
+        {
+          TRACE_FROM_MAIN(TRACE_UPLOAD_START, _latched_index);
+          if (self_test_next_frame())
+          {
+#ifdef ENABLE_UART
+            protocol_output_self_test();
+#endif
+          }
+          Send_self_test_spi_data(SELF_TEST_BRIGHT);
+          TRACE_FROM_MAIN(TRACE_UPLOAD_END, _latched_index);
+        }
+        else
+#endif // ENABLE_SELF_TEST
 #ifdef ENABLE_SIMULATION
-      if (_simulation_in_process)
-        Send_blanks_spi_data();
-      else
+        if (event.arg)
+        {
+          TRACE_FROM_MAIN(TRACE_UPLOAD_START, TRACE_UPLOAD_GROUP);
+          Send_blanks_spi_data(0);
+          TRACE_FROM_MAIN(TRACE_UPLOAD_END, TRACE_UPLOAD_GROUP);
+        }
+        else
+#endif
+        {
+          TRACE_FROM_MAIN(TRACE_UPLOAD_START, _latched_index);
+          Send_array_spi_data(_latched_index); // Serialize 80 (96) bit for IR LED's drivers
+          TRACE_FROM_MAIN(TRACE_UPLOAD_END, _latched_index);
+        }
+
+        // this is effectively index_16 = (index_16 + 1) % PATTERN_COUNT
+        // - advanced even for streamed frames, so the table stays in phase for fallback.
+        index_16++;
+        index_16 &= 0x0F;
+        _uploadsDone++;
+        break;
+      case EVENT_COMMIT_CONFIG:
+        if (_config_staged)
+          commit_config();
+        break;
+#ifdef ENABLE_MULTI_LEVEL
+      case EVENT_UPLOAD_LEVEL:
+        TRACE_FROM_MAIN(TRACE_UPLOAD_START, TRACE_UPLOAD_LEVEL | _latched_index);
+#ifdef ENABLE_SELF_TEST
+        // The self-test walks the pattern and dim pulses only.
+        if (self_test_frames_per_step())
+          event.arg = 1;
 #endif
-        Send_array_spi_data(); // Serialize 80 (96) bit for IR LED's drivers
+        if (event.arg)
+          Send_blanks_spi_data(LED_LINE_LENGTH); // no group: nothing lit
+        else
+          Send_level_spi_data(_latched_index);
+        TRACE_FROM_MAIN(TRACE_UPLOAD_END, TRACE_UPLOAD_LEVEL | _latched_index);
+        _uploadsDone++;
+        break;
+#endif // ENABLE_MULTI_LEVEL
+      }
+    }
 
-      // this is effectively index_16 = (index_16 + 1) % PATTERN_COUNT
-      index_16++;
-      index_16 &= 0x0F;
-      _procState = STATE_PROCESS_AWAITING_START;
-      break;
+#ifdef PHASE_REPORT_IN_USE
+    if (_phaseReport)
+    {
+      uint8_t report;
+      disableInterrupts();
+      report       = _phaseReport;
+      _phaseReport = 0;
+      enableInterrupts();
+#ifdef ENABLE_PHASE_REPORT
+      protocol_output_phase_report(report);
+#endif
+#ifdef ENABLE_PHASE_PULSE_CODE
+      Send_phase_pulse_code(report & PHASE_REPORT_ROW_MASK);
+#endif
     }
+#endif // PHASE_REPORT_IN_USE
 
 #ifdef ENABLE_UART
-    if (UART1_GetFlagStatus(UART1_FLAG_RXNE) == SET)
-      protocol_put_input_byte(UART1_ReceiveData8());
+    protocol_pump_output();
 
-    if (UART1_GetFlagStatus(UART1_FLAG_TXE) == SET && protocol_is_output_ready())
+    if (_rxRead != _rxWrite)
+    {
+      protocol_put_input_byte(_rxBytes[_rxRead & UART_RX_DEPTH_MASK]);
+      _rxRead++;
+    }
+
+    if (protocol_is_output_ready() && UART1_GetFlagStatus(UART1_FLAG_TXE) == SET)
       UART1_SendData8(protocol_get_output_byte());
 #endif
+
+#ifdef ENABLE_WAIT_FOR_INTERRUPT
+    // Sleep until an interrupt leaves work. wfi enables interrupts as it halts,
+    // so one arriving after these checks still wakes us.
+    disableInterrupts();
+    if (main_loop_is_idle())
+      wfi();
+    else
+      enableInterrupts();
+#endif
   }
 }
 
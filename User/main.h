@@ -44,5 +44,37 @@ uint8_t get_simulation_period();
 uint16_t get_flash_period();
 uint16_t get_blank_period();
 uint16_t get_interval_period();
+void set_level_period(uint16_t period);
+uint16_t get_level_period();
+
+/// Offsets (usec) taken from the process timer periods for the time spent in
+/// the handlers - measured at boot with ENABLE_CALIBRATION.
+enum
+{
+  ADJUSTMENT_FLASH = 0,
+  ADJUSTMENT_BLANK,
+  ADJUSTMENT_INTERVAL,
+  ADJUSTMENT_SYNC_DELAY,
+  ADJUSTMENT_COUNT
+};
+uint8_t get_timing_adjustment(uint8_t which);
+
+/// Flash on every divider-th camera sync, multiplier processes each (see
+/// sync_rate.h) - returns FALSE, changing nothing, if that doesn't fit the sync
+/// period measured. Ranges are the caller's to check.
+uint8_t set_sync_rate(uint8_t divider, uint8_t multiplier);
+uint8_t get_sync_divider();
+uint8_t get_sync_multiplier();
+/// Camera sync period last measured, usec - 0 if unknown.
+uint16_t get_sync_period();
+
+/// Boot timer ticks (BOOT_TIME_TICK_US each) from the clock setup to the end of
+/// the boot code, and to the first flash process - 0 if not there yet, U16_MAX
+/// if later than the timer counts. With ENABLE_BOOT_TIME.
+#define BOOT_TIME_TICK_US 8
+void get_boot_time(uint16_t *ready, uint16_t *first_flash);
+
+/// Row of the pattern table uploaded next, before the phase is applied.
+uint8_t get_pattern_index();
 
 #endif // INCLUDED_main_h_GUID_8FB0D036_FAEE_4295_A01B_1F028F261122
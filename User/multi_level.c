@@ -0,0 +1,93 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+
+/* Internal Includes */
+#include "multi_level.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+#ifdef ENABLE_MULTI_LEVEL
+NEAR uint8_t level_array[PATTERN_COUNT][LED_LINE_LENGTH];
+#endif
+
+uint8_t multi_level_get(uint8_t const *pattern_row, uint8_t const *level_row, uint8_t led)
+{
+  uint8_t bit   = (uint8_t)(1 << (led & 0x07));
+  uint8_t level = 0;
+  if (pattern_row[led >> 3] & bit)
+  {
+    level |= MULTI_LEVEL_PATTERN_BIT;
+  }
+  if (level_row[led >> 3] & bit)
+  {
+    level |= MULTI_LEVEL_PLANE_BIT;
+  }
+  return level;
+}
+
+void multi_level_set(uint8_t *pattern_row, uint8_t *level_row, uint8_t led, uint8_t level)
+{
+  uint8_t bit = (uint8_t)(1 << (led & 0x07));
+  if (level & MULTI_LEVEL_PATTERN_BIT)
+  {
+    pattern_row[led >> 3] |= bit;
+  }
+  else
+  {
+    pattern_row[led >> 3] &= (uint8_t)~bit;
+  }
+  if (level & MULTI_LEVEL_PLANE_BIT)
+  {
+    level_row[led >> 3] |= bit;
+  }
+  else
+  {
+    level_row[led >> 3] &= (uint8_t)~bit;
+  }
+}
+
+uint16_t multi_level_lit_us(uint8_t level, uint16_t flash_us, uint16_t level_us, uint16_t blank_us)
+{
+  uint16_t lit = blank_us;
+  if (level & MULTI_LEVEL_PATTERN_BIT)
+  {
+    lit += flash_us;
+  }
+  if (level & MULTI_LEVEL_PLANE_BIT)
+  {
+    lit += level_us;
+  }
+  return lit;
+}
@@ -0,0 +1,78 @@
+/** @file
+    @brief Header for multi-level brightness: a second bit plane beside the
+   pattern table, lighting its LEDs for a level pulse of its own, so each LED
+   shows one of four brightness levels per frame instead of bright or dim.
+
+    Must be c-safe! Shared with the desktop codec.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_multi_level_h_GUID_6E052CD0_183B_417C_9596_6D91213D32D5
+#define INCLUDED_multi_level_h_GUID_6E052CD0_183B_417C_9596_6D91213D32D5
+
+/* Internal Includes */
+#include "MCUConfig.h"
+#include "array_init.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Levels of an LED in a frame, dimmest first: the pattern bit (bright pulse)
+/// is the high bit, the level plane bit (level pulse) the low one. Every level
+/// gets the dim pulse too, so even level 0 is seen.
+#define MULTI_LEVEL_COUNT 4
+#define MULTI_LEVEL_PATTERN_BIT 0x02
+#define MULTI_LEVEL_PLANE_BIT 0x01
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/// Level of an LED given its pattern row and level plane row.
+uint8_t multi_level_get(uint8_t const *pattern_row, uint8_t const *level_row, uint8_t led);
+
+/// Splits a level for an LED into its bits in the two rows.
+void multi_level_set(uint8_t *pattern_row, uint8_t *level_row, uint8_t led, uint8_t level);
+
+/// Usec an LED is lit in a frame at a level, for the given pulse periods.
+uint16_t multi_level_lit_us(uint8_t level, uint16_t flash_us, uint16_t level_us, uint16_t blank_us);
+
+#ifdef ENABLE_MULTI_LEVEL
+
+/// The level plane, one row per pattern row, masked like the patterns - set
+/// with "GW", all clear at boot.
+extern NEAR uint8_t level_array[PATTERN_COUNT][LED_LINE_LENGTH];
+
+#endif // ENABLE_MULTI_LEVEL
+
+#ifdef __cplusplus
+};     // extern "C"
+#endif // __cplusplus
+
+#endif // INCLUDED_multi_level_h_GUID_6E052CD0_183B_417C_9596_6D91213D32D5
@@ -0,0 +1,56 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "perf_counters.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+#ifdef ENABLE_PERF_COUNTERS
+
+uint16_t perf_counters[PERF_COUNTER_COUNT];
+
+void perf_counters_reset(void)
+{
+  uint8_t i;
+  // The interrupt handlers increment these, and a 16-bit increment isn't atomic.
+  disableInterrupts();
+  for (i = 0; i < PERF_COUNTER_COUNT; i++)
+  {
+    perf_counters[i] = 0;
+  }
+  enableInterrupts();
+}
+
+#endif // ENABLE_PERF_COUNTERS
@@ -0,0 +1,95 @@
+/** @file
+    @brief Header for saturating event counters, read over the serial console
+   to check a board's health without a logic analyzer.
+
+    Must be c-safe!
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_perf_counters_h_GUID_9E9A4134_18DA_428F_A437_AAD69C923FE0
+#define INCLUDED_perf_counters_h_GUID_9E9A4134_18DA_428F_A437_AAD69C923FE0
+
+/* Internal Includes */
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Counter indices - this is also the order of the "TR" response.
+enum
+{
+  /// Camera syncs seen between flash processes, flashed or skipped by the divider
+  PERF_SYNCS = 0,
+  /// Flash processes started by the simulation timer
+  PERF_SIMULATED_SYNCS,
+  /// Camera syncs due a flash ignored because they arrived during a flash
+  /// process or its lockout (only heard there with a divider, or in the fixed
+  /// state machine's lockout)
+  PERF_LOCKOUT_SYNCS,
+  /// Flash processes that got past the startup delay
+  PERF_FRAMES_FLASHED,
+  /// Process timer went off before the main loop uploaded a between-pulse frame
+  PERF_MISSED_UPLOADS,
+  /// A sync arrived before the main loop uploaded the next pattern
+  PERF_LATE_PATTERNS,
+  /// Console output (responses or echo) dropped for lack of buffer space
+  PERF_UART_DROPPED,
+  /// Console input dropped because the receive ring was full
+  PERF_UART_OVERRUNS,
+  /// Syncs flashed once, their multiplier's extra processes dropped because they
+  /// didn't fit the sync period measured (or it wasn't known)
+  PERF_DROPPED_MULTIPLES,
+  PERF_COUNTER_COUNT
+};
+
+#ifdef ENABLE_PERF_COUNTERS
+
+extern uint16_t perf_counters[PERF_COUNTER_COUNT];
+
+/// Saturates rather than wrapping, so a stuck condition stays visible. Cheap
+/// enough for the interrupt handlers.
+#define PERF_COUNT(WHICH)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (perf_counters[WHICH] != 0xFFFF)                                                                                \
+      perf_counters[WHICH]++;                                                                                          \
+  } while (0)
+
+void perf_counters_reset(void);
+
+#else
+
+#define PERF_COUNT(WHICH)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+
+#endif // ENABLE_PERF_COUNTERS
+
+#endif // INCLUDED_perf_counters_h_GUID_9E9A4134_18DA_428F_A437_AAD69C923FE0
@@ -0,0 +1,54 @@
+/** @file
+    @brief Header for the per-sync pattern phase report: which row of the
+   pattern table the flash process following a sync shows.
+
+    Must be c-safe! Shared with the desktop decoder.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_phase_report_h_GUID_99AF7CE4_1CE4_4317_AB4B_F18FC914EDA0
+#define INCLUDED_phase_report_h_GUID_99AF7CE4_1CE4_4317_AB4B_F18FC914EDA0
+
+/* Internal Includes */
+/* none */
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// A report is one byte on the serial console, sent as the flash process
+/// starts. The high bit keeps it apart from console text, which is all ASCII.
+#define PHASE_REPORT_FLAG 0x80
+/// Set when the process was started by the simulation timer rather than a
+/// camera sync, so there's no camera frame to match.
+#define PHASE_REPORT_SIMULATED 0x10
+#define PHASE_REPORT_ROW_MASK 0x0F
+
+#define PHASE_REPORT_IS_REPORT(BYTE) (((BYTE)&PHASE_REPORT_FLAG) != 0)
+
+#endif // INCLUDED_phase_report_h_GUID_99AF7CE4_1CE4_4317_AB4B_F18FC914EDA0
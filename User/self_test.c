@@ -0,0 +1,93 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "self_test.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+uint8_t self_test_step_frame(uint8_t step, uint8_t *leds)
+{
+  uint8_t target = step >> 1;
+  uint8_t i;
+  for (i = 0; i < LED_LINE_LENGTH; i++)
+  {
+    leds[i] = 0;
+  }
+  if (target < SELF_TEST_LED_COUNT)
+  {
+    leds[target >> 3] = (uint8_t)(1 << (target & 0x07));
+  }
+  else
+  {
+    leds[target - SELF_TEST_LED_COUNT] = 0xFF;
+  }
+  return !(step & 0x01);
+}
+
+#ifdef ENABLE_SELF_TEST
+
+static uint8_t _frames_per_step = 0;
+static uint8_t _step            = 0;
+static uint8_t _frames_left     = 0;
+
+void self_test_start(uint8_t frames_per_step)
+{
+  _frames_per_step = frames_per_step;
+  // The next frame wraps around to step 0.
+  _step        = SELF_TEST_STEP_COUNT - 1;
+  _frames_left = 0;
+}
+
+uint8_t self_test_frames_per_step(void) { return _frames_per_step; }
+
+uint8_t self_test_step(void) { return _step; }
+
+uint8_t self_test_next_frame(void)
+{
+  if (_frames_left)
+  {
+    _frames_left--;
+    return 0;
+  }
+  _step++;
+  if (_step == SELF_TEST_STEP_COUNT)
+  {
+    _step = 0;
+  }
+  _frames_left = _frames_per_step - 1;
+  return 1;
+}
+
+#endif // ENABLE_SELF_TEST
@@ -0,0 +1,86 @@
+/** @file
+    @brief Header for the factory self-test: a walk lighting each LED alone,
+   bright then dim, then each driver byte group, a fixed number of frames per
+   step, so a test camera can check every LED of a board in seconds.
+
+    Must be c-safe! Shared with the desktop step table tool.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_self_test_h_GUID_5692C52C_2DD6_496F_B66A_7B58DBF3FF14
+#define INCLUDED_self_test_h_GUID_5692C52C_2DD6_496F_B66A_7B58DBF3FF14
+
+/* Internal Includes */
+#include "MCUConfig.h"
+#include "array_init.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+#define SELF_TEST_LED_COUNT LED_COUNT
+
+/// Even steps are bright (lit for the pattern pulse and the dim pulse), odd
+/// ones dim (dim pulse only): LED 0 bright, LED 0 dim, LED 1 bright... then
+/// driver byte group 0 bright, group 0 dim, and so on.
+#define SELF_TEST_STEP_COUNT (2 * (SELF_TEST_LED_COUNT + LED_LINE_LENGTH))
+
+#if SELF_TEST_STEP_COUNT > 255
+#error "Too many LEDs for the self-test's step numbers!"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/// Fills in the LEDs a step lights, as a pattern row (before masking) - returns
+/// nonzero for a bright step.
+uint8_t self_test_step_frame(uint8_t step, uint8_t *leds);
+
+#ifdef ENABLE_SELF_TEST
+
+/// Starts the walk over from step 0 at the next frame - or stops it, with 0
+/// frames per step. Main loop only, like the rest.
+void self_test_start(uint8_t frames_per_step);
+
+/// 0 when the self-test isn't running.
+uint8_t self_test_frames_per_step(void);
+
+uint8_t self_test_step(void);
+
+/// Call once per flash process, before uploading its pattern: moves the walk on
+/// - returns nonzero when a new step starts.
+uint8_t self_test_next_frame(void);
+
+#endif // ENABLE_SELF_TEST
+
+#ifdef __cplusplus
+};     // extern "C"
+#endif // __cplusplus
+
+#endif // INCLUDED_self_test_h_GUID_5692C52C_2DD6_496F_B66A_7B58DBF3FF14
@@ -0,0 +1,192 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "sequencer.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+uint8_t sequencer_step_is_valid(uint8_t index, SeqStep const *step, SeqStep const *program)
+{
+  uint8_t i;
+  if (index >= SEQ_MAX_STEPS)
+  {
+    return 0;
+  }
+  switch (step->op)
+  {
+  case SEQ_OP_END:
+    return 1;
+  case SEQ_OP_PULSE:
+  case SEQ_OP_WAIT:
+    return step->duration > SEQUENCER_STEP_ADJUSTMENT && step->duration < MAX_FLASH_PERIOD;
+  case SEQ_OP_UPLOAD:
+    if (step->arg < PATTERN_COUNT || step->arg == SEQ_FRAME_CURRENT_ROW || step->arg == SEQ_FRAME_LOOP_GROUP)
+    {
+      return 1;
+    }
+    return SEQ_FRAME_IS_GROUP(step->arg) && SEQ_FRAME_GROUP_NUMBER(step->arg) < LED_LINE_LENGTH;
+  case SEQ_OP_LOOP:
+    // Only backwards jumps, each loop counted to its end before another starts:
+    // so every program terminates.
+    if (step->arg >= index || step->duration == 0 || step->duration > SEQ_MAX_LOOP_COUNT)
+    {
+      return 0;
+    }
+    for (i = 0; i < SEQ_MAX_STEPS; i++)
+    {
+      // No loop inside this one, and none around it.
+      if (i != index && program[i].op == SEQ_OP_LOOP &&
+          ((i >= step->arg && i < index) || (i > index && program[i].arg <= index)))
+      {
+        return 0;
+      }
+    }
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+#ifdef ENABLE_SEQUENCER
+
+NEAR SeqStep seq_program[SEQ_MAX_STEPS];
+NEAR uint16_t seq_timer[SEQ_MAX_STEPS];
+
+// clang-format off
+/// The fixed state machine, as a program: bright pulse with the latched pattern,
+/// then a dim pulse per driver byte group, then the sync lockout.
+static const SeqStep default_program[] =
+{
+    {SEQ_OP_PULSE, 0, FLASH_BRIGHT_PERIOD},
+    {SEQ_OP_UPLOAD, SEQ_FRAME_LOOP_GROUP, 0},
+    {SEQ_OP_WAIT, 0, FLASH_INTERVAL_PERIOD},
+    {SEQ_OP_PULSE, 0, FLASH_DIM_PERIOD},
+    {SEQ_OP_LOOP, 1, LED_LINE_LENGTH},
+    {SEQ_OP_WAIT, 0, FLASH_SYNC_LOCKOUT_PERIOD},
+    {SEQ_OP_END, 0, 0}
+};
+// clang-format on
+
+#define DEFAULT_PROGRAM_LENGTH (sizeof(default_program) / sizeof(default_program[0]))
+
+/// The counter for a timed step: its duration less the step adjustment and the
+/// overhead of the upload and loop steps run before the next edge ends it. A
+/// loop is taken as jumping back, as it does every time but the last.
+static uint16_t step_timer(uint8_t index)
+{
+  uint16_t duration   = seq_program[index].duration;
+  uint16_t adjustment = SEQUENCER_STEP_ADJUSTMENT;
+  uint8_t pc          = index + 1;
+  uint8_t i;
+  for (i = 0; i < SEQ_MAX_STEPS && pc < SEQ_MAX_STEPS; i++)
+  {
+    SeqStep const *step = &seq_program[pc];
+    if (step->op == SEQ_OP_UPLOAD)
+    {
+      adjustment += SEQUENCER_UPLOAD_OVERHEAD;
+      pc++;
+    }
+    else if (step->op == SEQ_OP_LOOP)
+    {
+      adjustment += SEQUENCER_LOOP_OVERHEAD;
+      pc = step->duration > 1 ? step->arg : pc + 1;
+    }
+    else
+    {
+      break;
+    }
+  }
+  if (adjustment >= duration)
+  {
+    adjustment = duration - 1;
+  }
+  return MAX_FLASH_PERIOD - (duration - adjustment);
+}
+
+/// Works out seq_timer for the program, each entry in one go so the process
+/// timer interrupt never reads half of one.
+static void sequencer_prepare(void)
+{
+  uint8_t i;
+  for (i = 0; i < SEQ_MAX_STEPS; i++)
+  {
+    if (seq_program[i].op == SEQ_OP_PULSE || seq_program[i].op == SEQ_OP_WAIT)
+    {
+      uint16_t timer = step_timer(i);
+      disableInterrupts();
+      seq_timer[i] = timer;
+      enableInterrupts();
+    }
+  }
+}
+
+void sequencer_init(void)
+{
+  uint8_t i;
+  for (i = 0; i < SEQ_MAX_STEPS; i++)
+  {
+    if (i < DEFAULT_PROGRAM_LENGTH)
+    {
+      seq_program[i] = default_program[i];
+    }
+    else
+    {
+      seq_program[i].op       = SEQ_OP_END;
+      seq_program[i].arg      = 0;
+      seq_program[i].duration = 0;
+    }
+  }
+  sequencer_prepare();
+}
+
+uint8_t sequencer_set_step(uint8_t index, SeqStep const *step)
+{
+  if (!sequencer_step_is_valid(index, step, seq_program))
+  {
+    return FALSE;
+  }
+  // The process timer interrupt reads the program, so don't let it see a
+  // half-written step.
+  disableInterrupts();
+  seq_program[index] = *step;
+  enableInterrupts();
+  // A step changes the timing of the ones before it, as well as its own.
+  sequencer_prepare();
+  return TRUE;
+}
+
+void sequencer_get_step(uint8_t index, SeqStep *step) { *step = seq_program[index]; }
+
+#endif // ENABLE_SEQUENCER
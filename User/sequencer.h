@@ -0,0 +1,119 @@
+/** @file
+    @brief Header for the flash process micro-sequencer: a per-frame program of
+   pulse/wait/upload steps run by the process timer interrupt in place of the
+   fixed bright-then-dim state machine.
+
+    Must be c-safe! Shared with the desktop assembler.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_sequencer_h_GUID_F4D5017C_D5B1_40E6_9229_DABD12D3B5EB
+#define INCLUDED_sequencer_h_GUID_F4D5017C_D5B1_40E6_9229_DABD12D3B5EB
+
+/* Internal Includes */
+#include "MCUConfig.h"
+#include "array_init.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Maximum number of steps in a program.
+#define SEQ_MAX_STEPS 16
+
+/// Opcodes. Timed steps (pulse, wait) hand control back to the timer; the
+/// others run immediately, in the same interrupt.
+enum
+{
+  /// Turn LEDs off and finish the process: sync is re-enabled and the main loop
+  /// uploads the next pattern.
+  SEQ_OP_END = 0,
+  /// LEDs on (nOE low) with whatever frame is latched, for duration usec.
+  SEQ_OP_PULSE = 1,
+  /// LEDs off (nOE high) for duration usec - the main loop uploads any
+  /// requested frame meanwhile.
+  SEQ_OP_WAIT = 2,
+  /// Ask the main loop to latch the frame selected by arg (SEQ_FRAME_*).
+  SEQ_OP_UPLOAD = 3,
+  /// Jump back to step arg until the loop has run duration times in total, at
+  /// most SEQ_MAX_LOOP_COUNT. Loops don't nest: there's one loop counter.
+  SEQ_OP_LOOP = 4,
+  SEQ_OP_COUNT
+};
+
+/// Iteration count limit for SEQ_OP_LOOP - the loop counter is 8 bits.
+#define SEQ_MAX_LOOP_COUNT 255
+
+/// Frame selectors for SEQ_OP_UPLOAD: 0 to PATTERN_COUNT-1 select a row of
+/// pattern_array directly.
+#define SEQ_FRAME_CURRENT_ROW 0x40
+/// The "dim" frame lighting only the (masked) driver byte group in the low bits.
+#define SEQ_FRAME_GROUP 0x80
+/// The dim frame for the group numbered by the current loop iteration.
+#define SEQ_FRAME_LOOP_GROUP 0xC0
+
+#define SEQ_FRAME_IS_GROUP(FRAME) (((FRAME)&0xC0) == SEQ_FRAME_GROUP)
+#define SEQ_FRAME_GROUP_NUMBER(FRAME) ((FRAME)&0x3F)
+
+typedef struct SeqStep_
+{
+  uint8_t op;
+  uint8_t arg;
+  /// usec for timed steps, iteration count for loops.
+  uint16_t duration;
+} SeqStep;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/// Checks a step against the firmware's limits - returns nonzero if valid. A
+/// loop is also checked against the rest of the program (SEQ_MAX_STEPS steps),
+/// which it mustn't nest with.
+uint8_t sequencer_step_is_valid(uint8_t index, SeqStep const *step, SeqStep const *program);
+
+#ifdef ENABLE_SEQUENCER
+
+/// Loads the default program, equivalent to the fixed state machine.
+void sequencer_init(void);
+
+/// Returns FALSE (and leaves the program alone) if the step isn't valid.
+uint8_t sequencer_set_step(uint8_t index, SeqStep const *step);
+void sequencer_get_step(uint8_t index, SeqStep *step);
+
+extern NEAR SeqStep seq_program[SEQ_MAX_STEPS];
+/// The process timer counter for each timed step, from sequencer_prepare().
+extern NEAR uint16_t seq_timer[SEQ_MAX_STEPS];
+
+#endif // ENABLE_SEQUENCER
+
+#ifdef __cplusplus
+};     // extern "C"
+#endif // __cplusplus
+
+#endif // INCLUDED_sequencer_h_GUID_F4D5017C_D5B1_40E6_9229_DABD12D3B5EB
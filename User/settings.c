@@ -0,0 +1,64 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "settings.h"
+#include "array_init.h"
+
+/* Library/third-party includes */
+#include "stm8s.h"
+
+/* Standard includes */
+/* - none - */
+
+EEPROM uint8_t settings_boot_pattern_bank = DEFAULT_PATTERN_BANK;
+EEPROM uint8_t settings_boot_mask_bank    = DEFAULT_PATTERN_BANK;
+EEPROM uint8_t settings_device_id         = 0;
+
+void settings_write(EEPROM uint8_t *location, uint8_t value)
+{
+  if (*location == value)
+  {
+    return;
+  }
+
+  // Unlock the data EEPROM (the two keys go in the reverse order of program memory's)
+  FLASH->DUKR = FLASH_RASS_KEY2;
+  FLASH->DUKR = FLASH_RASS_KEY1;
+  while (!(FLASH->IAPSR & FLASH_IAPSR_DUL))
+  {
+  }
+
+  *location = value;
+  while (!(FLASH->IAPSR & FLASH_IAPSR_EOP))
+  {
+  }
+
+  // Lock it again
+  FLASH->IAPSR &= (uint8_t)(~FLASH_IAPSR_DUL);
+}
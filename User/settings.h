@@ -0,0 +1,54 @@
+/** @file
+    @brief Header for settings persisted across resets in the data EEPROM
+
+    Must be c-safe!
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_settings_h_GUID_036D60C3_1C7F_44DF_BA93_BAEFF045D009
+#define INCLUDED_settings_h_GUID_036D60C3_1C7F_44DF_BA93_BAEFF045D009
+
+/* Internal Includes */
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Pattern and mask banks (see array_init.h) loaded at boot.
+extern EEPROM uint8_t settings_boot_pattern_bank;
+extern EEPROM uint8_t settings_boot_mask_bank;
+
+/// Device ID (see array_init.h) applied on top of the boot banks - 0 for none.
+extern EEPROM uint8_t settings_device_id;
+
+/// Writes a byte of data EEPROM if it differs. This stalls the CPU, interrupts
+/// included, for a few msec - expect to drop a frame or so.
+void settings_write(EEPROM uint8_t *location, uint8_t value);
+
+#endif // INCLUDED_settings_h_GUID_036D60C3_1C7F_44DF_BA93_BAEFF045D009
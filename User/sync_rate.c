@@ -0,0 +1,67 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+
+/* Internal Includes */
+#include "sync_rate.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+uint16_t sync_rate_spacing(uint16_t period_us, uint8_t multiplier, uint16_t process_us)
+{
+  uint16_t spacing = period_us / multiplier;
+  if (spacing < process_us + SYNC_RATE_MIN_GAP_US || spacing - process_us >= MAX_FLASH_PERIOD)
+  {
+    return 0;
+  }
+  return spacing;
+}
+
+uint8_t sync_rate_fits(uint16_t period_us, uint8_t divider, uint8_t multiplier, uint16_t process_us)
+{
+  uint32_t end = (uint32_t)process_us + FLASH_SYNC_LOCKOUT_PERIOD;
+#ifdef SYNC_DELAY_TOTAL_US
+  end += SYNC_DELAY_TOTAL_US;
+#endif
+  if (multiplier > 1)
+  {
+    uint16_t spacing = sync_rate_spacing(period_us, multiplier, process_us);
+    if (!spacing)
+    {
+      return 0;
+    }
+    end += (uint32_t)spacing * (multiplier - 1);
+  }
+  return end <= (uint32_t)period_us * divider;
+}
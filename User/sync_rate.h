@@ -0,0 +1,82 @@
+/** @file
+    @brief Header for the sync rate budget: whether flashing on every Nth camera
+   sync (divider), or several flash processes per sync (multiplier), fits the
+   sync period - so one image serves every camera rate.
+
+    Must be c-safe! Shared with the desktop budget tool.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_sync_rate_h_GUID_DF510229_900F_427C_A422_DF2250C3CE5E
+#define INCLUDED_sync_rate_h_GUID_DF510229_900F_427C_A422_DF2250C3CE5E
+
+/* Internal Includes */
+#include "Config.h" // for uint8_t without conflicts
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+#define SYNC_DIVIDER_MAX 15
+
+#ifdef ENABLE_SYNC_MULTIPLIER
+#define SYNC_MULTIPLIER_MAX 4
+#else
+#define SYNC_MULTIPLIER_MAX 1
+#endif
+
+/// The simulation timer, restarted at every sync, measures the sync period: 16MHz / 128.
+#define SYNC_PERIOD_TICK_US 8
+/// Longer periods (slower than about 15Hz) aren't measured.
+#define SYNC_PERIOD_MAX_TICKS (0xFFFF / SYNC_PERIOD_TICK_US)
+
+/// Least time between the end of one process's dim pulses and the start of the
+/// next, for the main loop to upload the next pattern.
+#define SYNC_RATE_MIN_GAP_US 200
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/// Usec from the start of one flash process to the start of the next, the sync
+/// period split evenly by the multiplier - 0 if a process (usec, sync delay and
+/// lockout excluded) and the upload after it don't fit, or the process timer
+/// can't wait that long.
+uint16_t sync_rate_spacing(uint16_t period_us, uint8_t multiplier, uint16_t process_us);
+
+/// Nonzero if the schedule fits a sync period (usec): the first process after
+/// the sync delay, the others a spacing apart, and the last one's lockout ending
+/// before the next sync flashed, divider periods later.
+uint8_t sync_rate_fits(uint16_t period_us, uint8_t divider, uint8_t multiplier, uint16_t process_us);
+
+#ifdef __cplusplus
+};     // extern "C"
+#endif // __cplusplus
+
+#endif // INCLUDED_sync_rate_h_GUID_DF510229_900F_427C_A422_DF2250C3CE5E
@@ -0,0 +1,99 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+/* Internal Includes */
+#include "trace.h"
+#include "fast_io.h"
+
+/* Library/third-party includes */
+#ifdef OSVR_IR_STM8
+#include "stm8s.h"
+#endif
+
+/* Standard includes */
+/* - none - */
+
+#ifdef ENABLE_TRACE
+
+#define TRACE_DEPTH_MASK (TRACE_DEPTH - 1)
+
+uint8_t trace_mask = 0;
+
+static NEAR TraceRecord _records[TRACE_DEPTH];
+static uint8_t _head  = 0;
+static uint8_t _count = 0;
+static uint8_t _lost  = 0;
+
+void trace_record(uint8_t event, uint8_t arg)
+{
+  TraceRecord *record = &_records[_head];
+  record->event       = event;
+  record->arg         = arg;
+  FAST_TIM2_GET_COUNTER(record->time);
+  _head++;
+  _head &= TRACE_DEPTH_MASK;
+  if (_count == TRACE_DEPTH)
+  {
+    if (_lost != U8_MAX)
+    {
+      _lost++;
+    }
+  }
+  else
+  {
+    _count++;
+  }
+}
+
+uint8_t trace_pop(TraceRecord *out)
+{
+  uint8_t ret = FALSE;
+  disableInterrupts();
+  if (_count != 0)
+  {
+    *out = _records[(uint8_t)(_head - _count) & TRACE_DEPTH_MASK];
+    _count--;
+    ret = TRUE;
+  }
+  enableInterrupts();
+  return ret;
+}
+
+uint8_t trace_is_empty(void) { return _count == 0; }
+
+uint8_t trace_take_lost(void)
+{
+  uint8_t ret;
+  disableInterrupts();
+  ret   = _lost;
+  _lost = 0;
+  enableInterrupts();
+  return ret;
+}
+
+#endif // ENABLE_TRACE
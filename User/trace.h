@@ -0,0 +1,132 @@
+/** @file
+    @brief Header for the event trace: a small ring of timestamped records of
+   syncs, process timer steps, uploads and console commands, drained over the
+   serial console for post-mortems of timing problems.
+
+    Must be c-safe! Shared with the desktop decoder.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+/*
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef INCLUDED_trace_h_GUID_562876A3_318A_4A3E_BDD0_784F57B0B01D
+#define INCLUDED_trace_h_GUID_562876A3_318A_4A3E_BDD0_784F57B0B01D
+
+/* Internal Includes */
+#include "MCUConfig.h"
+
+/* Library/third-party includes */
+/* none */
+
+/* Standard includes */
+/* none */
+
+/// Event types - also the bit numbers of the trace mask.
+enum
+{
+  /// arg: 0 for a camera sync, 1 for a simulated one
+  TRACE_SYNC = 0,
+  /// Camera sync ignored during the lockout
+  TRACE_LOCKOUT_SYNC,
+  /// LEDs on with the pattern, after the startup delay - arg: pattern row
+  TRACE_FLASH_START,
+  /// End of a process timer interrupt - arg: state it left (sequencer: next step)
+  TRACE_PROCESS_TIMER,
+  /// arg: pattern row, TRACE_UPLOAD_GROUP | driver byte group for dim frames, or
+  /// TRACE_UPLOAD_LEVEL | pattern row for level plane frames
+  TRACE_UPLOAD_START,
+  TRACE_UPLOAD_END,
+  /// Console command parsed - arg: command letter
+  TRACE_COMMAND,
+  TRACE_EVENT_COUNT
+};
+
+#define TRACE_UPLOAD_GROUP 0x80
+#define TRACE_UPLOAD_LEVEL 0x40
+
+/// Timestamps are simulation timer counts since the last (real or simulated)
+/// sync: 16MHz / 128.
+#define TRACE_TICK_US 8
+
+/// Number of records kept - must be a power of two.
+#define TRACE_DEPTH 16
+
+typedef struct TraceRecord_
+{
+  uint8_t event;
+  uint8_t arg;
+  uint16_t time;
+} TraceRecord;
+
+#ifdef ENABLE_TRACE
+
+#if (TRACE_DEPTH & (TRACE_DEPTH - 1)) != 0
+#error "TRACE_DEPTH must be a power of two!"
+#endif
+
+/// Bit per event type to record - nothing is recorded until it's set.
+extern uint8_t trace_mask;
+
+/// Records into the ring, overwriting the oldest record when full. Not locked:
+/// call it from an interrupt handler, or use TRACE_FROM_MAIN.
+void trace_record(uint8_t event, uint8_t arg);
+
+/// Takes the oldest record - returns FALSE if there are none. Main loop only.
+uint8_t trace_pop(TraceRecord *out);
+
+uint8_t trace_is_empty(void);
+
+/// Number of records overwritten before being taken since the last call
+/// (saturating), then resets it.
+uint8_t trace_take_lost(void);
+
+#define TRACE(EVENT, ARG)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (trace_mask & (1 << (EVENT)))                                                                                   \
+      trace_record((EVENT), (ARG));                                                                                    \
+  } while (0)
+
+#define TRACE_FROM_MAIN(EVENT, ARG)                                                                                    \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (trace_mask & (1 << (EVENT)))                                                                                   \
+    {                                                                                                                  \
+      disableInterrupts();                                                                                             \
+      trace_record((EVENT), (ARG));                                                                                    \
+      enableInterrupts();                                                                                              \
+    }                                                                                                                  \
+  } while (0)
+
+#else
+
+#define TRACE(EVENT, ARG)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#define TRACE_FROM_MAIN(EVENT, ARG) TRACE(EVENT, ARG)
+
+#endif // ENABLE_TRACE
+
+#endif // INCLUDED_trace_h_GUID_562876A3_318A_4A3E_BDD0_784F57B0B01D
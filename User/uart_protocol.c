@@ -29,7 +29,15 @@
 /* Internal Includes */
 #include "uart_protocol.h"
 #include "main.h"
+#include "multi_level.h"
 #include "array_init.h"
+#include "frame_stream.h"
+#include "perf_counters.h"
+#include "self_test.h"
+#include "sequencer.h"
+#include "settings.h"
+#include "sync_rate.h"
+#include "trace.h"
 
 /* Library/third-party includes */
 #include "stm8s.h"
@@ -50,6 +58,21 @@ enum
   UART_COMMAND_INTERVAL   = 'I',
   UART_COMMAND_SIMULATION = 'S',
   UART_COMMAND_PATTERN    = 'P',
+  UART_COMMAND_QUEUE      = 'Q',
+  UART_COMMAND_SEQUENCE   = 'X',
+  UART_COMMAND_BANK       = 'K',
+  UART_COMMAND_BOOT_BANK  = 'O',
+  UART_COMMAND_DEVICE     = 'D',
+  UART_COMMAND_PHASE      = 'Y',
+  UART_COMMAND_TELEMETRY  = 'T',
+  UART_COMMAND_TRACE      = 'L',
+  UART_COMMAND_DUMP       = 'A',
+  UART_COMMAND_CALIBRATE  = 'C',
+  UART_COMMAND_SELF_TEST  = 'M',
+  UART_COMMAND_SYNC_RATE  = 'V',
+  UART_COMMAND_LEVEL_ROW  = 'G',
+  UART_COMMAND_LEVEL      = 'N',
+  UART_COMMAND_BOOT_TIME  = 'U',
   UART_COMMAND_ERROR      = 'E',
   UART_COMMAND_HELP       = 'H',
 };
@@ -71,8 +94,25 @@ enum
 // FW:10000\n\r
 // FR\n\r
 // PW:A:00,01,02,03,04
-
-#define UART_MAX_LINE_LENGTH 32
+// QW:00,01,02,03,04
+// XW:3:01,00,0096
+// KW:1,1
+// OW:1,1
+// DW:2
+// YW:1
+// TW
+// LW:7F,1
+// AR
+// CR
+// MW:02
+// VW:2,1
+// GW:A:00,01,02,03,04
+// NW:004B
+
+/// Room for the longest command, a row write ("PW:1:00,01,02,03,04,"), however
+/// many LEDs.
+#define UART_LED_LINE_COMMAND_LENGTH (5 + 3 * LED_LINE_LENGTH)
+#define UART_MAX_LINE_LENGTH (UART_LED_LINE_COMMAND_LENGTH > 32 ? UART_LED_LINE_COMMAND_LENGTH : 32)
 // UART_COMMAND _protocol_data = {0};
 ARRAY_ATTRIBUTE uint8_t _protocol_line[UART_MAX_LINE_LENGTH];
 uint8_t _protocol_length = 0;
@@ -122,6 +162,20 @@ void protocol_put_output_byte(uint8_t ch)
   _write_buffer.count++;
 }
 
+static uint8_t protocol_output_space() { return U8_MAX - _write_buffer.count; }
+
+/// Checks for room for length more bytes, counting the drop if there isn't.
+/// The count saturates at U8_MAX, so that's the usable size of the buffer.
+static bool protocol_has_output_space(uint8_t length)
+{
+  if (protocol_output_space() < length)
+  {
+    PERF_COUNT(PERF_UART_DROPPED);
+    return FALSE;
+  }
+  return TRUE;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -140,16 +194,74 @@ void protocol_parse_sim_write();
 void protocol_parse_pattern_read();
 void protocol_parse_pattern_write();
 
+#ifdef ENABLE_MULTI_LEVEL
+void protocol_parse_level_row_read();
+void protocol_parse_level_row_write();
+
+void protocol_parse_level_read();
+void protocol_parse_level_write();
+#endif
+
+#ifdef ENABLE_FRAME_STREAM
+void protocol_parse_queue_read();
+void protocol_parse_queue_write();
+#endif
+
+#ifdef ENABLE_SEQUENCER
+void protocol_parse_sequence_read();
+void protocol_parse_sequence_write();
+#endif
+
+void protocol_parse_bank_read();
+void protocol_parse_bank_write();
+
+void protocol_parse_boot_bank_read();
+void protocol_parse_boot_bank_write();
+
+void protocol_parse_device_read();
+void protocol_parse_device_write();
+
+void protocol_parse_calibration_read();
+
+void protocol_parse_sync_rate_read();
+void protocol_parse_sync_rate_write();
+
+#ifdef ENABLE_BOOT_TIME
+void protocol_parse_boot_time_read();
+#endif
+
+#ifdef ENABLE_PHASE_REPORT
+void protocol_parse_phase_read();
+void protocol_parse_phase_write();
+#endif
+
+#ifdef ENABLE_PERF_COUNTERS
+void protocol_parse_telemetry_read();
+void protocol_parse_telemetry_write();
+#endif
+
+#ifdef ENABLE_TRACE
+void protocol_parse_trace_read();
+void protocol_parse_trace_write();
+#endif
+
+#ifdef ENABLE_SELF_TEST
+void protocol_parse_self_test_write();
+#endif
+
 void protocol_output_error(uint8_t *info, uint8_t info_length);
 
-void protocol_help();
+/// Starts a multi-line reply, sent by protocol_pump_output().
+static void protocol_start_reply(uint8_t command);
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void protocol_put_input_byte(uint8_t ch)
 {
-  protocol_put_output_byte(ch);
+  // echo
+  if (protocol_has_output_space(1))
+    protocol_put_output_byte(ch);
 
   if (_protocol_length < UART_MAX_LINE_LENGTH)
     _protocol_line[_protocol_length++] = ch;
@@ -180,11 +292,39 @@ void protocol_put_input_byte(uint8_t ch)
     return;
   }
 
+  TRACE_FROM_MAIN(TRACE_COMMAND, _protocol_line[0]);
+
   switch (_protocol_line[0])
   {
   case UART_COMMAND_HELP:
-    protocol_help();
+    protocol_start_reply(UART_COMMAND_HELP);
     break;
+  case UART_COMMAND_DUMP:
+    if (read)
+      protocol_start_reply(UART_COMMAND_DUMP);
+    else
+      protocol_output_error("mode", 4);
+    break;
+  case UART_COMMAND_CALIBRATE:
+    if (read)
+      protocol_parse_calibration_read();
+    else
+      protocol_output_error("mode", 4);
+    break;
+  case UART_COMMAND_SYNC_RATE:
+    if (read)
+      protocol_parse_sync_rate_read();
+    else
+      protocol_parse_sync_rate_write();
+    break;
+#ifdef ENABLE_BOOT_TIME
+  case UART_COMMAND_BOOT_TIME:
+    if (read)
+      protocol_parse_boot_time_read();
+    else
+      protocol_output_error("mode", 4);
+    break;
+#endif
   case UART_COMMAND_FLASH:
     if (read)
       protocol_parse_flash_read();
@@ -215,6 +355,86 @@ void protocol_put_input_byte(uint8_t ch)
     else
       protocol_parse_pattern_write();
     break;
+#ifdef ENABLE_MULTI_LEVEL
+  case UART_COMMAND_LEVEL_ROW:
+    if (read)
+      protocol_parse_level_row_read();
+    else
+      protocol_parse_level_row_write();
+    break;
+  case UART_COMMAND_LEVEL:
+    if (read)
+      protocol_parse_level_read();
+    else
+      protocol_parse_level_write();
+    break;
+#endif
+#ifdef ENABLE_FRAME_STREAM
+  case UART_COMMAND_QUEUE:
+    if (read)
+      protocol_parse_queue_read();
+    else
+      protocol_parse_queue_write();
+    break;
+#endif
+#ifdef ENABLE_SEQUENCER
+  case UART_COMMAND_SEQUENCE:
+    if (read)
+      protocol_parse_sequence_read();
+    else
+      protocol_parse_sequence_write();
+    break;
+#endif
+  case UART_COMMAND_BANK:
+    if (read)
+      protocol_parse_bank_read();
+    else
+      protocol_parse_bank_write();
+    break;
+  case UART_COMMAND_BOOT_BANK:
+    if (read)
+      protocol_parse_boot_bank_read();
+    else
+      protocol_parse_boot_bank_write();
+    break;
+  case UART_COMMAND_DEVICE:
+    if (read)
+      protocol_parse_device_read();
+    else
+      protocol_parse_device_write();
+    break;
+#ifdef ENABLE_PHASE_REPORT
+  case UART_COMMAND_PHASE:
+    if (read)
+      protocol_parse_phase_read();
+    else
+      protocol_parse_phase_write();
+    break;
+#endif
+#ifdef ENABLE_PERF_COUNTERS
+  case UART_COMMAND_TELEMETRY:
+    if (read)
+      protocol_parse_telemetry_read();
+    else
+      protocol_parse_telemetry_write();
+    break;
+#endif
+#ifdef ENABLE_TRACE
+  case UART_COMMAND_TRACE:
+    if (read)
+      protocol_parse_trace_read();
+    else
+      protocol_parse_trace_write();
+    break;
+#endif
+#ifdef ENABLE_SELF_TEST
+  case UART_COMMAND_SELF_TEST:
+    if (read)
+      protocol_output_self_test();
+    else
+      protocol_parse_self_test_write();
+    break;
+#endif
   default:
     protocol_output_error("command", 7);
     _protocol_length = 0;
@@ -249,10 +469,8 @@ static void protocol_put_hex_uint16(uint16_t val)
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void protocol_output_error(uint8_t *info, uint8_t info_length)
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < info_length + 3) // "E:xxxxx\n"
+  if (!protocol_has_output_space(info_length + 4)) // "E:xxxxx\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_ERROR);
@@ -267,10 +485,8 @@ void protocol_output_error(uint8_t *info, uint8_t info_length)
 
 void protocol_output_string(uint8_t *info, uint8_t info_length)
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < info_length) // "E:xxxxx\n"
+  if (!protocol_has_output_space(info_length))
     return;
 
   while (info_length--)
@@ -364,10 +580,8 @@ void protocol_parse_flash_write()
 
 void protocol_parse_flash_read()
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < 8) // "FR:0010\n"
+  if (!protocol_has_output_space(9)) // "FR:0010\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_FLASH);
@@ -408,10 +622,8 @@ void protocol_parse_blank_write()
 
 void protocol_parse_blank_read()
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < 8) // "FR:0010\n"
+  if (!protocol_has_output_space(9)) // "FR:0010\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_BLANK);
@@ -453,10 +665,8 @@ void protocol_parse_interval_write()
 
 void protocol_parse_interval_read()
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < 8) // "FR:0010\n"
+  if (!protocol_has_output_space(9)) // "FR:0010\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_INTERVAL);
@@ -498,10 +708,8 @@ void protocol_parse_sim_write()
 
 void protocol_parse_sim_read()
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   // if overflow
-  if (space_available < 6) // "SR:10\n"
+  if (!protocol_has_output_space(7)) // "SR:10\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_SIMULATION);
@@ -516,6 +724,33 @@ void protocol_parse_sim_read()
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Parses LED_LINE_LENGTH comma-terminated hex bytes starting at offset in the
+/// line, as used by both pattern and queue writes.
+static bool parseLedLine(uint8_t offset, uint8_t *out)
+{
+  uint8_t i, j;
+  for (i = 0, j = offset; i < LED_LINE_LENGTH; i++)
+  {
+
+    uint8_t value;
+    bool parseSuccess = parseHexUint8(&(_protocol_line[j]), &value);
+    j += 2;
+    if (_protocol_line[j++] != UART_CHARACTER_COMMA)
+    {
+      protocol_output_error("comma", 5);
+      return FALSE;
+    }
+    if (!parseSuccess)
+    {
+      protocol_output_error("value", 5);
+      return FALSE;
+    }
+
+    out[i] = value;
+  }
+  return TRUE;
+}
+
 void protocol_parse_pattern_write()
 {
   if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[4] != UART_CHARACTER_DELIMITER)
@@ -530,25 +765,12 @@ void protocol_parse_pattern_write()
     protocol_output_error("index", 9);
     return;
   }
-  uint8_t i, j;
-  for (i = 0, j = 0; i < LED_LINE_LENGTH; i++)
-  {
-
-    uint8_t value;
-    bool parseSuccess = parseHexUint8(&(_protocol_line[5 + j]), &value);
-    j += 2;
-    if (_protocol_line[5 + j++] != UART_CHARACTER_COMMA)
-    {
-      protocol_output_error("comma", 5);
-      return;
-    }
-    if (!parseSuccess)
-    {
-      protocol_output_error("value", 5);
-      return;
-    }
 
-    pattern_array[index][i] = value;
+  // Off the flash tables, if still on them.
+  array_make_writable();
+  if (!parseLedLine(5, pattern_array[index]))
+  {
+    return;
   }
 
   line_array_init(index, pattern_array[index]);
@@ -558,8 +780,6 @@ void protocol_parse_pattern_write()
 
 void protocol_parse_pattern_read()
 {
-  uint8_t space_available = UART_MAX_WRITE_LENGTH - _write_buffer.count;
-
   if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
   {
     protocol_output_error("delimiter", 9);
@@ -574,7 +794,7 @@ void protocol_parse_pattern_read()
   }
 
   // if overflow
-  if (space_available < 20) // "PR:1:00,01,02,03,04\n"
+  if (!protocol_has_output_space(7 + 3 * LED_LINE_LENGTH)) // "PR:1:00,01,02,03,04,\r\n"
     return;
 
   protocol_put_output_byte(UART_COMMAND_PATTERN);
@@ -585,7 +805,7 @@ void protocol_parse_pattern_read()
   uint8_t i;
   for (i = 0; i < LED_LINE_LENGTH; i++)
   {
-    protocol_put_hex_uint8(pattern_array[index][i]);
+    protocol_put_hex_uint8(active_pattern_rows[index][i]);
     protocol_put_output_byte(UART_CHARACTER_COMMA);
   }
   protocol_put_output_byte(UART_CHARACTER_EOL);
@@ -595,27 +815,907 @@ void protocol_parse_pattern_read()
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_MULTI_LEVEL
+/// "GW:i:..." sets level plane row i, in the same format as "PW".
+void protocol_parse_level_row_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[4] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t index = hex_to_int(_protocol_line[3]);
+  if (index > PROTO_MAX_HEX_DIGIT_VAL)
+  {
+    protocol_output_error("index", 5);
+    return;
+  }
+
+  if (!parseLedLine(5, level_array[index]))
+  {
+    return;
+  }
+
+  protocol_parse_level_row_read();
+}
 
-void protocol_help()
+void protocol_parse_level_row_read()
 {
-  protocol_output_string("HW: FR/FW-flash period", 22);
-  protocol_put_output_byte(UART_CHARACTER_EOL);
-  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
 
-  protocol_output_string("HW: BR/BW-blank period", 22);
-  protocol_put_output_byte(UART_CHARACTER_EOL);
-  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+  uint8_t index = hex_to_int(_protocol_line[3]);
+  if (index > PROTO_MAX_HEX_DIGIT_VAL)
+  {
+    protocol_output_error("index", 5);
+    return;
+  }
+
+  // if overflow
+  if (!protocol_has_output_space(7 + 3 * LED_LINE_LENGTH)) // "GR:1:00,01,02,03,04,\r\n"
+    return;
 
-  protocol_output_string("HW: IR/IW-interval period", 25);
+  protocol_put_output_byte(UART_COMMAND_LEVEL_ROW);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(index);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  uint8_t i;
+  for (i = 0; i < LED_LINE_LENGTH; i++)
+  {
+    protocol_put_hex_uint8(level_array[index][i]);
+    protocol_put_output_byte(UART_CHARACTER_COMMA);
+  }
   protocol_put_output_byte(UART_CHARACTER_EOL);
   protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+/// "NW:0000" leaves the level pulse out.
+void protocol_parse_level_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint16_t value;
+  if (!parseHexUint16(&(_protocol_line[3]), &value))
+  {
+    return;
+  }
+
+  if (value != 0 && (value < 10 || value > 10000))
+  {
+    protocol_output_error("limit", 5);
+    return;
+  }
+
+  set_level_period(value);
+  protocol_parse_level_read();
+}
+
+void protocol_parse_level_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(9)) // "NR:004B\r\n"
+    return;
 
-  protocol_output_string("HW: SR/SW-simulation period", 27);
+  protocol_put_output_byte(UART_COMMAND_LEVEL);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint16(get_level_period());
   protocol_put_output_byte(UART_CHARACTER_EOL);
   protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_MULTI_LEVEL
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_FRAME_STREAM
+void protocol_parse_queue_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
 
-  protocol_output_string("HW: PR/PW-pattern", 17);
+  uint8_t frame[LED_LINE_LENGTH];
+  if (!parseLedLine(3, frame))
+  {
+    return;
+  }
+
+  if (!frame_stream_push(frame))
+  {
+    protocol_output_error("full", 4);
+    return;
+  }
+
+  protocol_parse_queue_read();
+}
+
+void protocol_parse_queue_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(12)) // "QR:01,0000\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_QUEUE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint8(frame_stream_count());
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint16(frame_stream_underruns());
   protocol_put_output_byte(UART_CHARACTER_EOL);
   protocol_put_output_byte(UART_CHARACTER_NEWLINE);
 }
+#endif // ENABLE_FRAME_STREAM
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_SEQUENCER
+void protocol_parse_sequence_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[4] != UART_CHARACTER_DELIMITER ||
+      _protocol_line[7] != UART_CHARACTER_COMMA || _protocol_line[10] != UART_CHARACTER_COMMA)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t index = hex_to_int(_protocol_line[3]);
+  if (index >= SEQ_MAX_STEPS)
+  {
+    protocol_output_error("index", 5);
+    return;
+  }
+
+  SeqStep step;
+  if (!parseHexUint8(&(_protocol_line[5]), &step.op) || !parseHexUint8(&(_protocol_line[8]), &step.arg) ||
+      !parseHexUint16(&(_protocol_line[11]), &step.duration))
+  {
+    return;
+  }
+
+  if (!sequencer_set_step(index, &step))
+  {
+    protocol_output_error("step", 4);
+    return;
+  }
+
+  protocol_parse_sequence_read();
+}
+
+void protocol_parse_sequence_read()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t index = hex_to_int(_protocol_line[3]);
+  if (index >= SEQ_MAX_STEPS)
+  {
+    protocol_output_error("index", 5);
+    return;
+  }
+
+  // if overflow
+  if (!protocol_has_output_space(17)) // "XR:3:01,00,0096\r\n"
+    return;
+
+  SeqStep step;
+  sequencer_get_step(index, &step);
+
+  protocol_put_output_byte(UART_COMMAND_SEQUENCE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(index);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint8(step.op);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint8(step.arg);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint16(step.duration);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_SEQUENCER
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Parses "p,m" (pattern bank, mask bank) at offset 3.
+static bool parseBankPair(uint8_t *pattern_bank, uint8_t *mask_bank)
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[4] != UART_CHARACTER_COMMA)
+  {
+    protocol_output_error("delimiter", 9);
+    return FALSE;
+  }
+
+  *pattern_bank = hex_to_int(_protocol_line[3]);
+  *mask_bank    = hex_to_int(_protocol_line[5]);
+  if (*pattern_bank >= PATTERN_BANK_COUNT || *mask_bank >= PATTERN_BANK_COUNT)
+  {
+    protocol_output_error("bank", 4);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static void protocol_output_bank_pair(uint8_t command, uint8_t pattern_bank, uint8_t mask_bank)
+{
+  protocol_put_output_byte(command);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(pattern_bank);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_nibble(mask_bank);
+}
+
+void protocol_parse_bank_write()
+{
+  uint8_t pattern_bank, mask_bank;
+  if (!parseBankPair(&pattern_bank, &mask_bank))
+  {
+    return;
+  }
+
+  // Same as uploading every line with PW: the main loop owns the tables.
+  bank_array_init(pattern_bank, mask_bank);
+
+  protocol_parse_bank_read();
+}
+
+void protocol_parse_bank_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(10)) // "KR:0,0,3\r\n"
+    return;
+
+  protocol_output_bank_pair(UART_COMMAND_BANK, active_pattern_bank, active_mask_bank);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_nibble(PATTERN_BANK_COUNT);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+void protocol_parse_boot_bank_write()
+{
+  uint8_t pattern_bank, mask_bank;
+  if (!parseBankPair(&pattern_bank, &mask_bank))
+  {
+    return;
+  }
+
+  settings_write(&settings_boot_pattern_bank, pattern_bank);
+  settings_write(&settings_boot_mask_bank, mask_bank);
+
+  protocol_parse_boot_bank_read();
+}
+
+void protocol_parse_boot_bank_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(8)) // "OR:0,0\r\n"
+    return;
+
+  protocol_output_bank_pair(UART_COMMAND_BOOT_BANK, settings_boot_pattern_bank, settings_boot_mask_bank);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void protocol_parse_device_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t device_id = hex_to_int(_protocol_line[3]);
+  if (device_id > DEVICE_ID_MAX)
+  {
+    protocol_output_error("device", 6);
+    return;
+  }
+
+  settings_write(&settings_device_id, device_id);
+  if (device_id == 0)
+  {
+    // Back to standalone: boot banks, no phase offset.
+    if (!bank_array_init(settings_boot_pattern_bank, settings_boot_mask_bank))
+    {
+      default_array_init();
+    }
+    pattern_phase = 0;
+  }
+  else
+  {
+    device_array_init(device_id);
+  }
+
+  protocol_parse_device_read();
+}
+
+void protocol_parse_device_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(10)) // "DR:2,0,8\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_DEVICE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(settings_device_id);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_nibble(active_pattern_bank);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_nibble(pattern_phase);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Timing adjustments in use: flash, blank, interval, sync delay.
+void protocol_parse_calibration_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(16)) // "CR:0E,0C,0C,0D\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_CALIBRATE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  uint8_t i;
+  for (i = 0; i < ADJUSTMENT_COUNT; i++)
+  {
+    if (i > 0)
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+    protocol_put_hex_uint8(get_timing_adjustment(i));
+  }
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_BOOT_TIME
+/// Boot timer ticks (BOOT_TIME_TICK_US) to the end of the boot code, and to the
+/// first flash - 0000 if there's been no sync yet.
+void protocol_parse_boot_time_read()
+{
+  uint16_t ready, first_flash;
+
+  // if overflow
+  if (!protocol_has_output_space(14)) // "UR:00C4,0D21\r\n"
+    return;
+
+  get_boot_time(&ready, &first_flash);
+  protocol_put_output_byte(UART_COMMAND_BOOT_TIME);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint16(ready);
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint16(first_flash);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_BOOT_TIME
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// "VW:d,m" flashes on every d-th camera sync, m flash processes each - refused
+/// if that doesn't fit the sync period measured. "VW:1,1" is the default.
+void protocol_parse_sync_rate_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[4] != UART_CHARACTER_COMMA)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t divider    = hex_to_int(_protocol_line[3]);
+  uint8_t multiplier = hex_to_int(_protocol_line[5]);
+  if (divider < 1 || divider > SYNC_DIVIDER_MAX || multiplier < 1 || multiplier > SYNC_MULTIPLIER_MAX)
+  {
+    protocol_output_error("value", 5);
+    return;
+  }
+  if (!set_sync_rate(divider, multiplier))
+  {
+    protocol_output_error("budget", 6);
+    return;
+  }
+
+  protocol_parse_sync_rate_read();
+}
+
+/// Divider, multiplier and the sync period measured (usec, 0000 if unknown).
+void protocol_parse_sync_rate_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(13)) // "VR:2,1,1047\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_SYNC_RATE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(get_sync_divider());
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_nibble(get_sync_multiplier());
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint16(get_sync_period());
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_PHASE_REPORT
+static uint8_t _phase_report_enabled = 0;
+
+void protocol_output_phase_report(uint8_t report)
+{
+  if (!_phase_report_enabled || !protocol_has_output_space(1))
+    return;
+
+  protocol_put_output_byte(report);
+}
+
+void protocol_parse_phase_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t enabled = hex_to_int(_protocol_line[3]);
+  if (enabled > 1)
+  {
+    protocol_output_error("value", 5);
+    return;
+  }
+  _phase_report_enabled = enabled;
+
+  protocol_parse_phase_read();
+}
+
+void protocol_parse_phase_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(6)) // "YR:1\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_PHASE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_nibble(_phase_report_enabled);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_PHASE_REPORT
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_PERF_COUNTERS
+/// Resets the counters, then reports them (all zero but for anything that
+/// happened in between).
+void protocol_parse_telemetry_write()
+{
+  perf_counters_reset();
+  protocol_parse_telemetry_read();
+}
+
+void protocol_parse_telemetry_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(3 + 5 * PERF_COUNTER_COUNT + 2)) // "TR:0001,0002,...,0007,\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_TELEMETRY);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  uint8_t i;
+  for (i = 0; i < PERF_COUNTER_COUNT; i++)
+  {
+    protocol_put_hex_uint16(perf_counters[i]);
+    protocol_put_output_byte(UART_CHARACTER_COMMA);
+  }
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_PERF_COUNTERS
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_TRACE
+/// Set by "LW": send the trace whenever the console is otherwise idle.
+static uint8_t _trace_streaming = 0;
+
+#define TRACE_LINE_HEADER_LENGTH 6 // "LR:00:"
+#define TRACE_LINE_RECORD_LENGTH 9 // "00112222,"
+
+/// "LR:" with the lost record count, then as many records as fit, oldest first.
+static void protocol_output_trace()
+{
+  protocol_put_output_byte(UART_COMMAND_TRACE);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint8(trace_take_lost());
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+
+  TraceRecord record;
+  while (protocol_output_space() >= TRACE_LINE_RECORD_LENGTH + 2 && trace_pop(&record))
+  {
+    protocol_put_hex_uint8(record.event);
+    protocol_put_hex_uint8(record.arg);
+    protocol_put_hex_uint16(record.time);
+    protocol_put_output_byte(UART_CHARACTER_COMMA);
+  }
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+
+void protocol_parse_trace_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER || _protocol_line[5] != UART_CHARACTER_COMMA)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t mask;
+  if (!parseHexUint8(&_protocol_line[3], &mask))
+    return;
+
+  uint8_t streaming = hex_to_int(_protocol_line[6]);
+  if (streaming > 1)
+  {
+    protocol_output_error("value", 5);
+    return;
+  }
+  trace_mask       = mask;
+  _trace_streaming = streaming;
+
+  protocol_parse_trace_read();
+}
+
+void protocol_parse_trace_read()
+{
+  // if overflow
+  if (!protocol_has_output_space(TRACE_LINE_HEADER_LENGTH + 2)) // "LR:00:00112222,...\r\n"
+    return;
+
+  protocol_output_trace();
+}
+#endif // ENABLE_TRACE
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ENABLE_SELF_TEST
+/// "MW:hh" starts the self-test over, holding each step for hh frames - "MW:00"
+/// stops it.
+void protocol_parse_self_test_write()
+{
+  if (_protocol_line[2] != UART_CHARACTER_DELIMITER)
+  {
+    protocol_output_error("delimiter", 9);
+    return;
+  }
+
+  uint8_t frames;
+  if (!parseHexUint8(&_protocol_line[3], &frames))
+    return;
+  self_test_start(frames);
+
+  protocol_output_self_test();
+}
+
+/// Frames per step (00 when stopped) and the current step, for the test camera.
+void protocol_output_self_test()
+{
+  // if overflow
+  if (!protocol_has_output_space(10)) // "MR:02,00\r\n"
+    return;
+
+  protocol_put_output_byte(UART_COMMAND_SELF_TEST);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+  protocol_put_hex_uint8(self_test_frames_per_step());
+  protocol_put_output_byte(UART_CHARACTER_COMMA);
+  protocol_put_hex_uint8(self_test_step());
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+}
+#endif // ENABLE_SELF_TEST
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Lines of the "AR" dump, in order. Every line but BUILD is ASCII hex fields
+/// like the single-setting replies:
+///   AR:T:flash,blank,interval,simulation,sync delay,lockout (usec, sim ms)
+///   AR:K:pattern bank,mask bank,device ID,phase
+///   AR:M:mask bytes
+///   AR:P:i:pattern row i bytes (one line per row)
+///   AR:N:index_16
+///   AR:V:BUILD_DESC
+///   AR:C:CRC-16 (CCITT, initial 0xFFFF) over the field values of the T, K, M
+///        and P lines in order, two bytes for 4-digit fields, one for the rest.
+enum
+{
+  DUMP_LINE_TIMING = 0,
+  DUMP_LINE_BANKS,
+  DUMP_LINE_MASK,
+  DUMP_LINE_PATTERN,
+  DUMP_LINE_INDEX = DUMP_LINE_PATTERN + PATTERN_COUNT,
+  DUMP_LINE_BUILD,
+  DUMP_LINE_CRC,
+  DUMP_LINE_COUNT
+};
+
+/// Longest line other than BUILD: "AR:T:0096,0064,0064,32,157C,03E8\r\n" - or,
+/// with more LEDs, a pattern row "AR:P:1:00,01,02,03,04,\r\n".
+#define DUMP_PATTERN_LINE_LENGTH (9 + 3 * LED_LINE_LENGTH)
+#define DUMP_MAX_LINE_LENGTH (DUMP_PATTERN_LINE_LENGTH > 34 ? DUMP_PATTERN_LINE_LENGTH : 34)
+
+extern const char BUILD_DESC[];
+
+static uint16_t _dump_crc;
+
+static void dump_crc_update(uint8_t val)
+{
+  uint8_t i;
+  _dump_crc ^= ((uint16_t)val) << 8;
+  for (i = 0; i < 8; i++)
+    _dump_crc = (_dump_crc & 0x8000) ? (_dump_crc << 1) ^ 0x1021 : (_dump_crc << 1);
+}
+
+static void dump_put_nibble(uint8_t val)
+{
+  dump_crc_update(val);
+  protocol_put_hex_nibble(val);
+}
+
+static void dump_put_uint8(uint8_t val)
+{
+  dump_crc_update(val);
+  protocol_put_hex_uint8(val);
+}
+
+static void dump_put_uint16(uint16_t val)
+{
+  dump_put_uint8((uint8_t)(val >> 8));
+  dump_put_uint8((uint8_t)val);
+}
+
+static void dump_put_led_line(uint8_t const *line)
+{
+  uint8_t i;
+  for (i = 0; i < LED_LINE_LENGTH; i++)
+  {
+    dump_put_uint8(line[i]);
+    protocol_put_output_byte(UART_CHARACTER_COMMA);
+  }
+}
+
+/// Outputs one line of the dump - returns FALSE if there's no room for it yet.
+static bool protocol_output_dump_line(uint8_t line)
+{
+  // BUILD_DESC is long: wait until the buffer is empty rather than measure it.
+  if (line == DUMP_LINE_BUILD ? _write_buffer.count != 0 : protocol_output_space() < DUMP_MAX_LINE_LENGTH)
+    return FALSE;
+
+  protocol_put_output_byte(UART_COMMAND_DUMP);
+  protocol_put_output_byte(UART_MODE_READ);
+  protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+
+  if (line >= DUMP_LINE_PATTERN && line < DUMP_LINE_INDEX)
+  {
+    uint8_t index = line - DUMP_LINE_PATTERN;
+    protocol_put_output_byte('P');
+    protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+    dump_put_nibble(index);
+    protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+    dump_put_led_line(active_pattern_rows[index]);
+  }
+  else
+  {
+    switch (line)
+    {
+    case DUMP_LINE_TIMING:
+      _dump_crc = 0xFFFF;
+      protocol_put_output_byte('T');
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      dump_put_uint16(get_flash_period());
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_uint16(get_blank_period());
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_uint16(get_interval_period());
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_uint8(get_simulation_period());
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+#ifdef SYNC_DELAY_TOTAL_US
+      dump_put_uint16(SYNC_DELAY_TOTAL_US);
+#else
+      dump_put_uint16(0);
+#endif // SYNC_DELAY_TOTAL_US
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_uint16(FLASH_SYNC_LOCKOUT_PERIOD);
+      break;
+
+    case DUMP_LINE_BANKS:
+      protocol_put_output_byte(UART_COMMAND_BANK);
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      dump_put_nibble(active_pattern_bank);
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_nibble(active_mask_bank);
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_nibble(settings_device_id);
+      protocol_put_output_byte(UART_CHARACTER_COMMA);
+      dump_put_nibble(pattern_phase);
+      break;
+
+    case DUMP_LINE_MASK:
+      protocol_put_output_byte('M');
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      dump_put_led_line(pattern_banks[active_mask_bank].mask);
+      break;
+
+    case DUMP_LINE_INDEX:
+      protocol_put_output_byte('N');
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      protocol_put_hex_uint8(get_pattern_index());
+      break;
+
+    case DUMP_LINE_BUILD:
+    {
+      char const *desc = BUILD_DESC;
+      protocol_put_output_byte('V');
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      while (*desc)
+        protocol_put_output_byte(*desc++);
+      break;
+    }
+
+    case DUMP_LINE_CRC:
+      protocol_put_output_byte('C');
+      protocol_put_output_byte(UART_CHARACTER_DELIMITER);
+      protocol_put_hex_uint16(_dump_crc);
+      break;
+    }
+  }
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static char const *const help_lines[] = {
+    "HW: FR/FW-flash period",
+    "HW: BR/BW-blank period",
+    "HW: IR/IW-interval period",
+    "HW: SR/SW-simulation period",
+    "HW: PR/PW-pattern",
+#ifdef ENABLE_MULTI_LEVEL
+    "HW: GR/GW-level plane",
+    "HW: NR/NW-level period",
+#endif
+    "HW: KR/KW-pattern,mask bank",
+    "HW: OR/OW-boot bank",
+    "HW: DR/DW-device ID",
+    "HW: AR-dump all settings",
+    "HW: VR/VW-sync divide,multiply",
+    "HW: CR-timing adjustments",
+#ifdef ENABLE_BOOT_TIME
+    "HW: UR-boot time, 8us ticks",
+#endif
+#ifdef ENABLE_PHASE_REPORT
+    "HW: YR/YW-phase reports",
+#endif
+#ifdef ENABLE_PERF_COUNTERS
+    "HW: TR/TW-counters/reset",
+#endif
+#ifdef ENABLE_TRACE
+    "HW: LR/LW-trace mask,stream",
+#endif
+#ifdef ENABLE_SELF_TEST
+    "HW: MR/MW-self-test frames",
+#endif
+#ifdef ENABLE_FRAME_STREAM
+    "HW: QR/QW-queue stream frame",
+#endif
+#ifdef ENABLE_SEQUENCER
+    "HW: XR/XW-sequencer step",
+#endif
+};
+
+#define HELP_LINE_COUNT (sizeof(help_lines) / sizeof(help_lines[0]))
+#define HELP_MAX_LINE_LENGTH 30
+
+/// Outputs one line of help - returns FALSE if there's no room for it yet.
+static bool protocol_output_help_line(uint8_t line)
+{
+  if (protocol_output_space() < HELP_MAX_LINE_LENGTH)
+    return FALSE;
+
+  char const *text = help_lines[line];
+  while (*text)
+    protocol_put_output_byte(*text++);
+  protocol_put_output_byte(UART_CHARACTER_EOL);
+  protocol_put_output_byte(UART_CHARACTER_NEWLINE);
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Multi-line reply in progress (help or the dump), sent a line at a time as the
+/// buffer drains, and the next line to send.
+static uint8_t _reply_command = UART_COMMAND_NONE;
+static uint8_t _reply_line    = 0;
+
+static void protocol_start_reply(uint8_t command)
+{
+  _reply_command = command;
+  _reply_line    = 0;
+}
+
+void protocol_pump_output()
+{
+  switch (_reply_command)
+  {
+  case UART_COMMAND_HELP:
+    if (protocol_output_help_line(_reply_line) && ++_reply_line == HELP_LINE_COUNT)
+      _reply_command = UART_COMMAND_NONE;
+    return;
+
+  case UART_COMMAND_DUMP:
+    if (protocol_output_dump_line(_reply_line) && ++_reply_line == DUMP_LINE_COUNT)
+      _reply_command = UART_COMMAND_NONE;
+    return;
+  }
+
+#ifdef ENABLE_TRACE
+  // Only between replies, so a streamed line never splits one.
+  if (_trace_streaming && _write_buffer.count == 0 && !trace_is_empty())
+    protocol_output_trace();
+#endif
+}
+
+uint8_t protocol_has_work()
+{
+  if (_reply_command != UART_COMMAND_NONE)
+    return TRUE;
+#ifdef ENABLE_TRACE
+  if (_trace_streaming && !trace_is_empty())
+    return TRUE;
+#endif
+  return FALSE;
+}
 #endif
@@ -40,6 +40,24 @@ uint8_t protocol_is_output_ready();
 uint8_t protocol_get_output_byte();
 void protocol_put_input_byte(uint8_t ch);
 
+/// Call every main loop iteration: queues unsolicited output (e.g. a streamed
+/// trace) when the console is idle.
+void protocol_pump_output();
+
+/// Whether protocol_pump_output() has more to queue (a multi-line reply or a
+/// streamed trace), so the main loop shouldn't sleep yet.
+uint8_t protocol_has_work();
+
+#ifdef ENABLE_PHASE_REPORT
+/// Queues a phase report byte, if reports are turned on and there's room.
+void protocol_output_phase_report(uint8_t report);
+#endif
+
+#ifdef ENABLE_SELF_TEST
+/// Queues the self-test state ("MR" reply) - sent as each step starts.
+void protocol_output_self_test();
+#endif
+
 #endif
 
 #endif